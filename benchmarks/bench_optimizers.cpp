@@ -0,0 +1,245 @@
+// Performance suite for the optimizers.
+//
+// For each optimizer, population size and dimension it measures:
+//   - overhead per iteration: time spent outside the objective, per iteration,
+//     with the cheap sphere function as objective;
+//   - evaluations per second on the chosen test function;
+//   - time to target: wall-clock seconds until the best fitness reaches
+//     --target on the chosen function (or the iteration budget runs out).
+//
+// Results are written as JSON in the layout of google-benchmark's
+// --benchmark_format=json (a "context" object and a "benchmarks" array), or
+// as CSV with --csv, so runs can be diffed and tracked for regressions.
+//
+// Usage: bioopt_bench [--function NAME] [--iterations N] [--repeats N]
+//                     [--target F] [--threads N] [--sizes 32,128] [--dims 10,50]
+//                     [--float32] [--csv]
+//
+// --float32 runs PSO and SMA in float32 mode; the GA stays float64.
+
+#include "benchmark_functions.h"
+#include "ga.h"
+#include "pso.h"
+#include "sma.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string function = "rastrigin";
+    int iterations = 200;
+    int repeats = 3;
+    double target = 1e-2;
+    int threads = 1;
+    std::vector<int> sizes = {32, 128, 512};
+    std::vector<int> dims = {10, 50, 200};
+    bool float32 = false;
+    bool csv = false;
+};
+
+struct Result {
+    std::string optimizer;
+    int size;
+    int dim;
+    double overhead_ns_per_iteration;
+    double evaluations_per_second;
+    double time_to_target_seconds;  // Negative if the target was not reached.
+    int iterations_to_target;
+};
+
+using Factory = std::function<std::unique_ptr<BaseOptimizer>(int size, int dim, double lb, double ub, int iterations)>;
+
+std::vector<int> parse_list(const char* text) {
+    std::vector<int> values;
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        values.push_back(std::atoi(item.c_str()));
+    }
+    return values;
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--csv") {
+            options.csv = true;
+        } else if (arg == "--float32") {
+            options.float32 = true;
+        } else if (arg == "--function" && has_value) {
+            options.function = argv[++i];
+        } else if (arg == "--iterations" && has_value) {
+            options.iterations = std::atoi(argv[++i]);
+        } else if (arg == "--repeats" && has_value) {
+            options.repeats = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--target" && has_value) {
+            options.target = std::atof(argv[++i]);
+        } else if (arg == "--threads" && has_value) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--sizes" && has_value) {
+            options.sizes = parse_list(argv[++i]);
+        } else if (arg == "--dims" && has_value) {
+            options.dims = parse_list(argv[++i]);
+        } else {
+            throw std::runtime_error("Unknown or incomplete argument: " + arg);
+        }
+    }
+    return options;
+}
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Best (smallest) of `repeats` measurements, the usual way to suppress noise.
+template <typename Measure>
+double best_of(int repeats, Measure measure) {
+    double best = measure();
+    for (int r = 1; r < repeats; ++r) {
+        best = std::min(best, measure());
+    }
+    return best;
+}
+
+Result run_case(const Options& options, const std::string& name, const Factory& base_make, int size, int dim) {
+    Result result{name, size, dim, 0.0, 0.0, -1.0, -1};
+    Factory make = [&](int n, int d, double lb, double ub, int it) {
+        std::unique_ptr<BaseOptimizer> optimizer = base_make(n, d, lb, ub, it);
+        if (options.float32 && name != "GA") {
+            optimizer->set_precision(Precision::Float32);
+        }
+        return optimizer;
+    };
+    BenchmarkFunction cheap("sphere", dim);
+    BenchmarkFunction function(options.function, dim);
+    double lb = function.get_lower_bound();
+    double ub = function.get_upper_bound();
+
+    // Overhead: total time minus the timed evaluation phase, per iteration.
+    result.overhead_ns_per_iteration = best_of(options.repeats, [&] {
+        std::unique_ptr<BaseOptimizer> optimizer = make(size, dim, lb, ub, options.iterations);
+        optimizer->set_native_objective(&BenchmarkFunction::call, &cheap);
+        optimizer->set_num_threads(options.threads);
+        optimizer->configure_instrumentation(true, false);
+        Clock::time_point start = Clock::now();
+        optimizer->optimize(options.iterations);
+        double total = seconds_since(start);
+        double evaluating = optimizer->get_instrumentation().get_phase_seconds()[static_cast<int>(Phase::Evaluation)];
+        return (total - evaluating) / std::max(options.iterations, 1) * 1e9;
+    });
+
+    // Throughput on the chosen function.
+    result.evaluations_per_second = 1.0 / best_of(options.repeats, [&] {
+        std::unique_ptr<BaseOptimizer> optimizer = make(size, dim, lb, ub, options.iterations);
+        optimizer->set_native_objective(&BenchmarkFunction::call, &function);
+        optimizer->set_num_threads(options.threads);
+        Clock::time_point start = Clock::now();
+        optimizer->optimize(options.iterations);
+        return seconds_since(start) / static_cast<double>(std::max<uint64_t>(optimizer->get_evaluation_count(), 1));
+    });
+
+    // Time to target, with the iteration budget as the cap.
+    std::unique_ptr<BaseOptimizer> optimizer = make(size, dim, lb, ub, options.iterations);
+    optimizer->set_native_objective(&BenchmarkFunction::call, &function);
+    optimizer->set_num_threads(options.threads);
+    TerminationCriteria criteria;
+    criteria.has_target = true;
+    criteria.target_fitness = options.target;
+    optimizer->set_termination(criteria);
+    Clock::time_point start = Clock::now();
+    optimizer->optimize(options.iterations);
+    if (optimizer->get_stop_reason() == StopReason::TargetReached) {
+        result.time_to_target_seconds = seconds_since(start);
+        result.iterations_to_target = optimizer->get_iteration();
+    }
+    return result;
+}
+
+void write_json(const Options& options, const std::vector<Result>& results) {
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    std::printf("{\n  \"context\": {\n");
+    std::printf("    \"date\": \"%s\",\n", date);
+    std::printf("    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    std::printf("    \"function\": \"%s\",\n", options.function.c_str());
+    std::printf("    \"iterations\": %d,\n", options.iterations);
+    std::printf("    \"repeats\": %d,\n", options.repeats);
+    std::printf("    \"target\": %.17g,\n", options.target);
+    std::printf("    \"threads\": %d,\n", options.threads);
+    std::printf("    \"precision\": \"%s\"\n", options.float32 ? "float32" : "float64");
+    std::printf("  },\n  \"benchmarks\": [\n");
+    for (size_t k = 0; k < results.size(); ++k) {
+        const Result& r = results[k];
+        std::printf("    {\"name\": \"%s/%d/%d\", \"optimizer\": \"%s\", \"num_individuals\": %d, \"dim\": %d, "
+                    "\"overhead_ns_per_iteration\": %.1f, \"evaluations_per_second\": %.1f, "
+                    "\"time_to_target_seconds\": %.6g, \"iterations_to_target\": %d}%s\n",
+                    r.optimizer.c_str(), r.size, r.dim, r.optimizer.c_str(), r.size, r.dim,
+                    r.overhead_ns_per_iteration, r.evaluations_per_second,
+                    r.time_to_target_seconds, r.iterations_to_target,
+                    k + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+void write_csv(const std::vector<Result>& results) {
+    std::printf("name,optimizer,num_individuals,dim,overhead_ns_per_iteration,evaluations_per_second,"
+                "time_to_target_seconds,iterations_to_target\n");
+    for (const Result& r : results) {
+        std::printf("%s/%d/%d,%s,%d,%d,%.1f,%.1f,%.6g,%d\n", r.optimizer.c_str(), r.size, r.dim,
+                    r.optimizer.c_str(), r.size, r.dim, r.overhead_ns_per_iteration,
+                    r.evaluations_per_second, r.time_to_target_seconds, r.iterations_to_target);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options options = parse_options(argc, argv);
+        std::vector<std::pair<std::string, Factory>> optimizers = {
+            {"PSO", [](int n, int d, double lb, double ub, int it) {
+                 return std::unique_ptr<BaseOptimizer>(new PSO(n, d, lb, ub, it, 1.5, 1.5, 0.7));
+             }},
+            {"SMA", [](int n, int d, double lb, double ub, int it) {
+                 return std::unique_ptr<BaseOptimizer>(new SMA(n, d, lb, ub, it, 1.0, 1.0, 0.5));
+             }},
+            {"GA", [](int n, int d, double lb, double ub, int it) {
+                 return std::unique_ptr<BaseOptimizer>(new GA(n, d, lb, ub, it, true, false, 42, 0.7, 0.05, 3, 2));
+             }},
+        };
+        std::vector<Result> results;
+        for (const auto& entry : optimizers) {
+            for (int size : options.sizes) {
+                for (int dim : options.dims) {
+                    results.push_back(run_case(options, entry.first, entry.second, size, dim));
+                }
+            }
+        }
+        if (options.csv) {
+            write_csv(results);
+        } else {
+            write_json(options, results);
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bioopt_bench: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
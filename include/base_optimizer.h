@@ -1,14 +1,57 @@
 #ifndef BASE_OPTIMIZER_H
 #define BASE_OPTIMIZER_H
 
+#include "checkpoint.h"
+#include "fitness_cache.h"
+#include "history.h"
+#include "instrumentation.h"
+#include "population.h"
+#include "random_stream.h"
+#include "surrogate.h"
+#include "termination.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <cstdint>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 
 /**
  * @brief Abstract base class for optimization algorithms.
  */
 class BaseOptimizer {
 public:
+    /**
+     * @brief Objective evaluated on a single candidate solution.
+     */
+    using ObjectiveFunction = std::function<double(const std::vector<double>&)>;
+
+    /**
+     * @brief Objective evaluated on a whole population at once.
+     *
+     * Receives `count` candidates of `dim` values each, stored contiguously in
+     * row-major order, and must write `count` fitness values to `fitness`.
+     */
+    using BatchObjectiveFunction = std::function<void(const double* positions, int count, int dim, double* fitness)>;
+
+    /**
+     * @brief Batch objective taking single-precision candidates, for float32 mode.
+     */
+    using BatchObjectiveFunction32 = std::function<void(const float* positions, int count, int dim, double* fitness)>;
+
+    /**
+     * @brief Called every few iterations with the optimizer; return true to stop.
+     */
+    using ProgressCallback = std::function<bool(const BaseOptimizer&)>;
+
+    /**
+     * @brief Plain C objective: `dim` values in place, plus caller-supplied data.
+     */
+    using NativeObjective = double (*)(const double* x, std::size_t dim, void* user_data);
+
     /**
      * @brief Construct a new Base Optimizer object.
      *
@@ -16,33 +59,346 @@ public:
      * @param dim Dimensionality of the search space.
      * @param lower_bound Lower bound for the search space.
      * @param upper_bound Upper bound for the search space.
+     * @param max_iter Default number of iterations for optimize().
+     * @param minimize True for minimization problems.
+     * @param verbose Print the best fitness after every iteration.
+     * @param store_history_each_iter If true, record history every iteration.
      */
-    BaseOptimizer(int num_individuals, int dim, double lower_bound, double upper_bound)
+    BaseOptimizer(int num_individuals, int dim, double lower_bound, double upper_bound,
+                  int max_iter = 100, bool minimize = true, bool verbose = false,
+                  bool store_history_each_iter = false)
         : num_individuals(num_individuals), dim(dim),
-          lower_bound(lower_bound), upper_bound(upper_bound) {}
+          lower_bound(lower_bound), upper_bound(upper_bound),
+          max_iter(max_iter), minimize(minimize), verbose(verbose),
+          store_history_each_iter(store_history_each_iter),
+          horizon(max_iter) {
+        population_history.reset(num_individuals, dim);
+    }
 
-    virtual ~BaseOptimizer() {}  // Virtual destructor
+    // Waits for evaluations abandoned by an asynchronous timeout to return.
+    virtual ~BaseOptimizer();
 
     /**
      * @brief Set the objective function.
      *
+     * Replaces any previously set batch objective.
+     *
      * @param obj A callable that accepts a std::vector<double> and returns a double.
+     * @param thread_safe If true, the objective may be called from several threads at once.
+     */
+    virtual void set_objective(ObjectiveFunction obj, bool thread_safe = true);
+
+    /**
+     * @brief Set a batch objective function, called once per generation.
+     *
+     * Replaces any previously set per-individual objective.
+     *
+     * @param obj A callable that evaluates the whole population in one call.
+     * @param obj32 Optional single-precision variant. In float32 mode it gets
+     *        the population as stored; without it rows are widened to double
+     *        for `obj`.
+     */
+    virtual void set_batch_objective(BatchObjectiveFunction obj, BatchObjectiveFunction32 obj32 = nullptr);
+
+    /**
+     * @brief Set a plain C function as the objective.
+     *
+     * Rows are passed in place, with no copy and no wrapper in between, so
+     * this is the cheapest way to call compiled code. Replaces any other
+     * objective.
+     *
+     * @param fn Objective; called with a row of the population, `dim` and `user_data`.
+     * @param user_data Passed through to every call.
+     * @param thread_safe If true, `fn` may be called from several threads at once.
+     * @param owner Kept alive for as long as the objective is set (e.g. the
+     *        object `user_data` points into).
+     */
+    void set_native_objective(NativeObjective fn, void* user_data = nullptr, bool thread_safe = true,
+                              std::shared_ptr<const void> owner = nullptr);
+
+    /**
+     * @brief Set the number of threads used to evaluate the population.
+     *
+     * The worker pool is created here and kept for the lifetime of the
+     * optimizer. Only thread-safe per-individual objectives are evaluated in
+     * parallel; batch objectives are always called once from the caller.
+     *
+     * @param num_threads Number of threads (1 = serial, 0 = hardware concurrency).
+     */
+    void set_num_threads(int num_threads);
+
+    /**
+     * @brief Get the number of threads used to evaluate the population.
+     */
+    int get_num_threads() const;
+
+    /**
+     * @brief Cache fitness values by genome, so repeated genomes skip the objective.
+     *
+     * Worth enabling when the objective is expensive and deterministic.
+     * Resets the hit/miss counters.
+     *
+     * @param capacity Maximum number of cached genomes (0 disables the cache).
+     */
+    void set_fitness_cache(int capacity) { fitness_cache.configure(capacity, dim); }
+
+    /**
+     * @brief Get the fitness cache (for its hit/miss counters).
+     */
+    const FitnessCache& get_fitness_cache() const { return fitness_cache; }
+
+    /**
+     * @brief Pre-screen candidates with a surrogate, so only promising ones reach the objective.
+     *
+     * Every evaluated genome goes into the surrogate's archive. Once the
+     * archive holds min_points genomes, each generation's candidates are
+     * ranked by predicted fitness: the best evaluate_fraction of them and
+     * an explore_fraction drawn at random from the rest are evaluated, the
+     * others keep their predictions. A prediction is never better than the
+     * worst of the best-ranked candidates evaluated in the same step, so the
+     * best solution is always a truly evaluated one. Worth enabling when the
+     * objective is expensive. Applies where the optimizer calls the objective
+     * itself, not in async mode or to values supplied through tell().
+     *
+     * @param settings Surrogate settings (capacity 0 disables the surrogate).
+     */
+    void set_surrogate(const SurrogateSettings& settings) { surrogate.configure(settings, dim); }
+
+    /**
+     * @brief Get the surrogate (for the number of evaluations it saved).
+     */
+    const Surrogate& get_surrogate() const { return surrogate; }
+
+    /**
+     * @brief Number of individuals evaluated so far, by the objective or through tell().
+     */
+    uint64_t get_evaluation_count() const { return evaluation_count; }
+
+    /**
+     * @brief Switch optimize() to asynchronous steady-state evaluation.
+     *
+     * Instead of evaluating whole generations behind a barrier, a new
+     * candidate is generated and handed to a worker as soon as one is free,
+     * so slow individuals do not hold up the rest. One iteration then means
+     * num_individuals completed evaluations. Results depend on completion
+     * order and are not reproducible. Needs a per-individual objective; it
+     * runs on get_num_threads() workers (one if it is not thread-safe).
+     *
+     * @param enabled True for asynchronous mode, false for the generational loop.
+     * @param timeout_seconds Evaluations not finished this long after being
+     *        dispatched are marked failed and given the worst possible
+     *        fitness (0 = no timeout). optimize() does not wait for them;
+     *        they finish on their own threads, which the optimizer keeps and
+     *        joins at the start of the next run or when it is destroyed. The
+     *        objective and its `user_data` must stay valid until then.
+     */
+    void set_async_mode(bool enabled, double timeout_seconds = 0.0);
+
+    /**
+     * @brief Whether optimize() runs in asynchronous mode.
+     */
+    bool get_async_mode() const { return async_mode; }
+
+    /**
+     * @brief Number of evaluations marked failed by the asynchronous timeout.
+     */
+    uint64_t get_failed_evaluations() const { return failed_evaluations; }
+
+    /**
+     * @brief Choose the precision the population is stored and updated in.
+     *
+     * Float32 halves the memory of the per-individual arrays and doubles the
+     * number of elements each vector instruction of the update kernels
+     * handles. Fitness values and the best solution stay double; objectives
+     * see the rounded positions (widened to double unless a single-precision
+     * batch objective is set). Must be chosen before the initial population
+     * is evaluated; the initial population is then drawn again, as in a
+     * fresh optimizer, and rounded.
+     *
+     * @param precision Float64 (the default) or Float32.
+     */
+    void set_precision(Precision precision);
+
+    /**
+     * @brief Precision of the population storage.
+     */
+    Precision get_precision() const { return precision; }
+
+    /**
+     * @brief The current population as stored in float32 mode (nullptr in float64 mode).
+     *
+     * Like get_population(), updated in place as the optimizer runs.
+     */
+    virtual const Population32* get_population32() const { return nullptr; }
+
+    /**
+     * @brief Set extra stopping rules for optimize().
+     *
+     * The rules are checked after every iteration (and, in asynchronous
+     * mode, the evaluation and time budgets before every dispatch), so a
+     * generational run may overshoot max_evaluations by up to one
+     * generation. Also restarts the stagnation window.
+     *
+     * @param criteria Rules to apply; default-constructed criteria disable all.
+     */
+    void set_termination(const TerminationCriteria& criteria);
+
+    /**
+     * @brief Get the stopping rules set by set_termination().
+     */
+    const TerminationCriteria& get_termination() const { return termination; }
+
+    /**
+     * @brief Why the last optimize() call returned.
+     *
+     * In ask()/tell() loops this reports the first rule met, if any.
+     */
+    StopReason get_stop_reason() const { return stop_reason; }
+
+    /**
+     * @brief Turn on per-phase timers and per-iteration statistics.
+     *
+     * Drops anything collected so far. Timers cover the generational loop;
+     * in asynchronous mode only the statistics are collected.
+     *
+     * @param timers Time evaluation, update, selection, bounds and history.
+     * @param statistics Record best/mean fitness, diversity and evaluation
+     *        count after every iteration.
      */
-    virtual void set_objective(std::function<double(const std::vector<double>&)> obj) = 0;
+    void configure_instrumentation(bool timers, bool statistics) { instrumentation.configure(timers, statistics); }
+
+    /**
+     * @brief Get the collected timings and statistics.
+     */
+    const Instrumentation& get_instrumentation() const { return instrumentation; }
+
+    /**
+     * @brief Call `callback` after every `every`-th iteration.
+     *
+     * If it returns true, optimize() stops with StopReason::Callback.
+     *
+     * @param callback Function to call (empty to remove).
+     * @param every Iterations between calls.
+     */
+    void set_progress_callback(ProgressCallback callback, int every = 1);
 
     /**
      * @brief Run the optimization process.
      *
+     * The first call evaluates the initial population; later calls resume
+     * where the previous one stopped, so several short calls behave like
+     * one long one. Candidates handed out by ask() and not yet told are
+     * evaluated first.
+     *
      * @param iterations Number of iterations to run (-1 for default max iterations).
      */
-    virtual void optimize(int iterations) = 0;
+    virtual void optimize(int iterations);
+
+    /**
+     * @brief Get the candidates whose fitness the next tell() must supply.
+     *
+     * The first ask() returns the initial population; each later one
+     * advances the algorithm by one iteration. Calling ask() again before
+     * tell() returns the same candidates. The reference stays valid, but
+     * its contents change on the next ask(). In float32 mode this is a
+     * widened copy; get_population32() has the candidates as stored.
+     *
+     * @return const Population& Candidates, one row per individual.
+     */
+    const Population& ask();
+
+    /**
+     * @brief ask() in float32 mode: the candidates as stored, without the
+     *        widened copy ask() returns.
+     */
+    const Population32& ask32();
+
+    /**
+     * @brief Rows of the asked candidates that need evaluating, or nullptr for all.
+     *
+     * The other rows are unchanged since their last evaluation and
+     * get_fitness() already holds their values; tell() still takes a value
+     * for every row, but ignores those of the other rows and counts only
+     * these as evaluations. Outside drivers need only evaluate these rows.
+     */
+    virtual const std::vector<int>* candidate_rows() const { return nullptr; }
+
+    /**
+     * @brief Supply the fitness of the candidates returned by ask().
+     *
+     * @param fitness One value per candidate, in row order.
+     * @param count Number of values (must equal the number of candidates).
+     */
+    void tell(const double* fitness, int count);
+
+    /**
+     * @brief Supply the fitness of the candidates returned by ask().
+     */
+    void tell(const std::vector<double>& fitness) { tell(fitness.data(), static_cast<int>(fitness.size())); }
+
+    /**
+     * @brief Start a run that an outside loop steps through ask()/tell().
+     *
+     * Does what optimize() does before its first step: clears the stop
+     * reason, starts the max_seconds deadline and aims schedules such as
+     * inertia decay at the end of the run. The loop should then evaluate
+     * the initial population if has_started() is false, check
+     * stop_requested() once, and step until `iterations` iterations are
+     * done or get_stop_reason() is set; end_run() closes the run.
+     *
+     * @param iterations Iterations the run will take (-1 for max_iter).
+     * @return int The iteration count, with -1 resolved.
+     */
+    int begin_run(int iterations);
+
+    /**
+     * @brief Run up to `count` more iterations of the run begin_run() started.
+     *
+     * optimize() is begin_run(), continue_run() and end_run(). Calling
+     * continue_run() several times between one begin_run() and end_run()
+     * keeps a single max_seconds deadline and schedule horizon for the whole
+     * run, where repeated optimize() calls would restart them. Stops early
+     * when get_stop_reason() is set.
+     *
+     * @param count Iterations to run.
+     */
+    void continue_run(int count);
+
+    /**
+     * @brief Check every stopping rule, setting get_stop_reason() when one is met.
+     *
+     * Rules are checked by tell() after every iteration; this is for the
+     * check optimize() also makes before its first iteration.
+     */
+    bool stop_requested() { return should_stop(); }
+
+    /**
+     * @brief Finish a run started with begin_run(), as optimize() finishes.
+     *
+     * Sets StopReason::MaxIterations if no rule stopped the run, and records
+     * the final history snapshot unless history is recorded every iteration.
+     */
+    void end_run();
+
+    /**
+     * @brief Whether the initial population has been evaluated.
+     */
+    bool has_started() const { return started; }
+
+    /**
+     * @brief Number of completed iterations (the initial evaluation is not counted).
+     */
+    int get_iteration() const { return iteration; }
 
     /**
      * @brief Get the best solution found.
      *
-     * @return std::vector<double> Best solution vector.
+     * The reference stays valid, and is updated in place, for the lifetime
+     * of the optimizer.
+     *
+     * @return const std::vector<double>& Best solution vector.
      */
-    virtual std::vector<double> get_best_solution() const = 0;
+    virtual const std::vector<double>& get_best_solution() const = 0;
 
     /**
      * @brief Get the best fitness value.
@@ -51,11 +407,414 @@ public:
      */
     virtual double get_best_fitness() const = 0;
 
+    /**
+     * @brief Get the current population (one row per individual).
+     *
+     * The storage is allocated once at construction and updated in place.
+     * In float32 mode it is a double copy of get_population32(), refreshed
+     * by each call.
+     */
+    virtual const Population& get_population() const = 0;
+
+    /**
+     * @brief Get the fitness of each individual in the current population.
+     */
+    virtual const std::vector<double>& get_fitness() const = 0;
+
+    /**
+     * @brief Configure how history is recorded, dropping recorded snapshots.
+     *
+     * Snapshots are taken every iteration when the optimizer was created with
+     * store_history_each_iter, otherwise once at the end of optimize().
+     *
+     * @param options Capacity, stride, record-positions flag and spill file.
+     */
+    void configure_history(const HistoryOptions& options) { population_history.configure(options); }
+
+    /**
+     * @brief Copy out the `count` fittest individuals of the current population.
+     *
+     * @param count Number of individuals (clamped to the population size).
+     * @param genomes Output, `count` x dim values in row-major order.
+     * @param fitness Output, the matching fitness values, best first.
+     */
+    virtual void export_migrants(int count, std::vector<double>& genomes, std::vector<double>& fitness) const;
+
+    /**
+     * @brief Bring in individuals from elsewhere, replacing the worst ones.
+     *
+     * Each migrant replaces the current worst individual if it is better.
+     * Call between optimize() calls, not while candidates are out for ask().
+     *
+     * @param genomes `count` x dim values in row-major order.
+     * @param fitness Fitness of each migrant.
+     * @param count Number of migrants.
+     */
+    void import_migrants(const double* genomes, const double* fitness, int count);
+
+    /**
+     * @brief Save the complete optimizer state to a checkpoint file.
+     *
+     * Covers the population and every per-individual array, the best
+     * solution, the random stream position, counters, stopping rules and the
+     * fitness cache; restoring it and continuing gives the same results as
+     * an uninterrupted run. The objective, thread count and recorded history
+     * are not saved. The file is replaced atomically.
+     *
+     * @param path File to write.
+     */
+    void save_checkpoint(const std::string& path) const;
+
+    /**
+     * @brief Restore the state written by save_checkpoint().
+     *
+     * The file is memory-mapped and arrays are copied straight from the
+     * mapping into the optimizer. It must come from the same algorithm with
+     * the same number of individuals and dimension.
+     *
+     * @param path File to read.
+     */
+    void load_checkpoint(const std::string& path);
+
+    /**
+     * @brief The checkpoint save_checkpoint() would write, as bytes.
+     */
+    std::vector<unsigned char> serialize() const;
+
+    /**
+     * @brief Restore a checkpoint held in memory.
+     */
+    void deserialize(const unsigned char* data, std::size_t size);
+
+    int get_dim() const { return dim; }
+    int get_num_individuals() const { return num_individuals; }
+    bool get_minimize() const { return minimize; }
+
+    /**
+     * @brief Get the recorded history.
+     */
+    const History& get_history() const { return population_history; }
+
+    /**
+     * @brief Retrieve the population history as nested vectors.
+     *
+     * @return std::vector<std::vector<std::vector<double>>> Population history.
+     */
+    std::vector<std::vector<std::vector<double>>> get_population_history() const {
+        return population_history.to_vectors();
+    }
+
 protected:
     int num_individuals;
     int dim;
     double lower_bound;
     double upper_bound;
+    int max_iter;
+    bool minimize;
+    bool verbose;
+    bool store_history_each_iter;
+
+    ObjectiveFunction objective_function;
+    BatchObjectiveFunction batch_objective_function;
+    BatchObjectiveFunction32 batch_objective_function32;
+    NativeObjective native_objective = nullptr;
+    void* native_user_data = nullptr;
+    std::shared_ptr<const void> native_owner;
+    bool objective_thread_safe = true;
+
+    // Worker pool for parallel evaluation and updates (null when running serially).
+    std::unique_ptr<ThreadPool> thread_pool;
+
+    // Counter-based RNG state. Streams are keyed by (rng_seed, rng_step, individual);
+    // step 0 is initialization and every generation advances rng_step.
+    uint64_t rng_seed = 0;
+    uint64_t rng_step = 0;
+
+    // Optional fitness cache and the number of objective evaluations made.
+    FitnessCache fitness_cache;
+    uint64_t evaluation_count = 0;
+
+    // Optional surrogate pre-screening of candidates.
+    Surrogate surrogate;
+
+    // Run state. `iteration` counts completed iterations; `horizon` is the
+    // iteration count schedules such as inertia decay run towards.
+    int iteration = 0;
+    int horizon;
+    bool started = false;
+    bool asked = false;
+
+    // Asynchronous mode settings; `async_step` keys the random streams of
+    // asynchronous proposals.
+    bool async_mode = false;
+    double async_timeout = 0.0;
+    uint64_t async_step = 0;
+    uint64_t failed_evaluations = 0;
+
+    // Stopping rules and their state: the wall-clock deadline of the current
+    // optimize() call and the best fitness the stagnation window started from.
+    TerminationCriteria termination;
+    StopReason stop_reason = StopReason::NotStopped;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    double stagnation_best = 0.0;
+    int stagnation_since = 0;
+
+    // Storage precision chosen with set_precision().
+    Precision precision = Precision::Float64;
+
+    // Recorded snapshots, stamped with the iteration number.
+    History population_history;
+
+    // Phase timers and per-iteration statistics.
+    Instrumentation instrumentation;
+
+    /**
+     * @brief Name stored in checkpoints, checked when one is restored.
+     */
+    virtual const char* algorithm_name() const = 0;
+
+    /**
+     * @brief Write the algorithm's own parameters and state to a checkpoint.
+     */
+    virtual void save_state(CheckpointWriter& out) const = 0;
+
+    /**
+     * @brief Restore what save_state() wrote.
+     */
+    virtual void load_state(CheckpointReader& in) = 0;
+
+    /**
+     * @brief Check whether either kind of objective has been set.
+     */
+    bool has_objective() const;
+
+    /**
+     * @brief Evaluate every individual of a population.
+     *
+     * Uses the batch objective when one is set (a single call for the whole
+     * population), otherwise calls the per-individual objective, in parallel
+     * when a thread pool is configured. Fitness values always land at their
+     * individual's index, so any reduction done afterwards is deterministic.
+     *
+     * @param positions Population to evaluate.
+     * @param fitness Output fitness values, resized to the population size.
+     */
+    void evaluate(const Population& positions, std::vector<double>& fitness);
+
+    /**
+     * @brief Evaluate only the listed rows of a population.
+     *
+     * Fitness of the other rows is left untouched, so callers can carry over
+     * values of individuals that did not change.
+     *
+     * @param positions Population to evaluate.
+     * @param fitness Output fitness values, one per row of `positions`.
+     * @param rows Indices of the rows to evaluate.
+     */
+    void evaluate(const Population& positions, std::vector<double>& fitness, const std::vector<int>& rows);
+
+    /**
+     * @brief Evaluate every individual of a single-precision population.
+     *
+     * Rows are widened to double for the objective, except for a
+     * single-precision batch objective, which gets them as they are.
+     */
+    void evaluate(const Population32& positions, std::vector<double>& fitness);
+
+    /**
+     * @brief Whether the algorithm can run in float32 mode.
+     */
+    virtual bool supports_float32() const { return false; }
+
+    /**
+     * @brief Reallocate the per-individual state for the new `precision`
+     *        and draw the initial population again.
+     */
+    virtual void precision_changed() {}
+
+    /**
+     * @brief Widened copy of the single-precision population, for get_population().
+     *
+     * The copy is made on the first call after population_changed() and
+     * then shared by every caller until the next change, so references and
+     * views taken in between all see the same, current values.
+     */
+    const Population& widened(const Population32& population) const;
+
+    /**
+     * @brief Mark the single-precision population as changed, so widened()
+     *        copies it again.
+     *
+     * Called by the base class after every hook that moves individuals
+     * (generate(), replace_individual(), propose_async(), load_state() and
+     * precision_changed()), and by public methods of subclasses that move
+     * them outside those hooks.
+     */
+    void population_changed();
+
+    /**
+     * @brief Run a per-individual update over [0, count), on the thread pool if set.
+     *
+     * Rows must be independent of each other; with per-individual random
+     * streams the result is then identical for any thread count.
+     *
+     * @param count Number of rows.
+     * @param body Callable invoked as body(begin, end).
+     */
+    void parallel_rows(int count, const std::function<void(int, int)>& body);
+
+    /**
+     * @brief Record a history snapshot of the current generation.
+     *
+     * @param force Record even if the history stride skips this generation.
+     */
+    void record_history(bool force = false);
+
+    /**
+     * @brief Fitness storage matching the rows of get_population().
+     */
+    virtual std::vector<double>& fitness_buffer() = 0;
+
+    /**
+     * @brief Take in the fitness of the initial population.
+     */
+    virtual void absorb_initial() = 0;
+
+    /**
+     * @brief Advance the algorithm, leaving new candidates in get_population().
+     */
+    virtual void generate() = 0;
+
+    /**
+     * @brief Move the current generation back into the storage
+     *        get_population() had when the run started.
+     *
+     * For algorithms whose generate() swaps buffers. Called whenever the
+     * population is handed out: by ask(), before a progress callback and by
+     * end_run(), so views of get_population() keep tracking the generation.
+     */
+    virtual void settle_population() {}
+
+    /**
+     * @brief Take in the fitness of the candidates produced by generate().
+     */
+    virtual void absorb() = 0;
+
+    /**
+     * @brief Evaluate the current candidates with the objective.
+     *
+     * The default evaluates every row; algorithms that know some rows are
+     * unchanged may evaluate fewer.
+     */
+    virtual void evaluate_candidates();
+
+    /**
+     * @brief Overwrite individual `i` with `genome`, whose fitness is known.
+     *
+     * Implementations also update any per-individual memory and the best
+     * solution found.
+     */
+    virtual void replace_individual(int i, const double* genome, double fitness) = 0;
+
+    /**
+     * @brief Replace the worst individual with `genome` if it is better.
+     *
+     * @return true if the genome was taken in.
+     */
+    bool replace_worst(const double* genome, double fitness);
+
+    /**
+     * @brief Whether the algorithm implements the asynchronous hooks below.
+     */
+    virtual bool supports_async() const { return false; }
+
+    /**
+     * @brief Prepare for an asynchronous run (no evaluations are in flight).
+     */
+    virtual void begin_async() {}
+
+    /**
+     * @brief Write the next candidate to evaluate into `candidate`.
+     *
+     * @return A slot id passed back to accept_async(), or -1 if no candidate
+     *         can be produced until an in-flight one completes.
+     */
+    virtual int propose_async(double* candidate);
+
+    /**
+     * @brief Take in the fitness of a candidate from propose_async().
+     *
+     * Failed evaluations arrive with the worst possible fitness.
+     */
+    virtual void accept_async(int slot, const double* candidate, double fitness);
+
+private:
+    // Evaluate the asked (or next) candidates and take in their fitness.
+    void step();
+
+    // Advance to the next candidates unless they are already out for ask().
+    void prepare_candidates();
+
+    // Diversity of the population as stored.
+    double current_diversity() const;
+
+    // Take in the fitness now held in fitness_buffer().
+    void finish_step();
+
+    // Count one finished iteration: verbose output, history and stopping rules.
+    void end_iteration();
+
+    // Check the evaluation and time budgets; sets stop_reason when one is used up.
+    bool budget_exhausted();
+
+    // Check every stopping rule; sets stop_reason when one is met.
+    bool should_stop();
+
+    // Start a new stagnation window at the current best fitness.
+    void restart_stagnation();
+
+    // Asynchronous steady-state loop running `count` iterations' worth of evaluations.
+    void run_async(int count);
+
+    // Threads left inside evaluations abandoned by the asynchronous timeout,
+    // and the wait for them to return.
+    std::vector<std::thread> async_stragglers;
+    void join_async_stragglers();
+
+    // Append the current best/mean fitness and diversity to the statistics.
+    void record_statistics();
+
+    ProgressCallback progress_callback;
+    int callback_every = 1;
+
+    // Scratch for evaluate(): rows still to evaluate, gathered (or widened)
+    // rows for batch objectives, and one widened row for cache lookups.
+    std::vector<int> pending_rows;
+    Population staging;
+    Population32 staging32;
+    std::vector<double> staging_fitness;
+    std::vector<double> widened_row;
+
+    // Scratch for surrogate screening: rows sent to the objective, the
+    // best-ranked of them, and rows kept at their predicted fitness.
+    std::vector<int> selected_rows;
+    std::vector<int> promising_rows;
+    std::vector<int> screened_rows;
+    std::vector<double> screened_fitness;
+    std::vector<double> predicted;
+    std::vector<int> screen_order;
+
+    // Backing store of widened(), valid while `widened_current` is set.
+    mutable std::mutex widened_mutex;
+    mutable Population widened_population;
+    mutable bool widened_current = false;
+
+    template <typename T>
+    void evaluate_rows(const BasicPopulation<T>& positions, std::vector<double>& fitness, const int* rows, int count);
+
+    // Keep the rows surrogate screening sends to the objective; returns their count.
+    template <typename T>
+    int screen_rows(const BasicPopulation<T>& positions, const int*& rows, int count);
 };
 
 #endif // BASE_OPTIMIZER_H
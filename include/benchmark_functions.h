@@ -0,0 +1,97 @@
+#ifndef BENCHMARK_FUNCTIONS_H
+#define BENCHMARK_FUNCTIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Standard test functions on `dim` values. All are minimized with optimum 0,
+// at the origin except Rosenbrock (all ones).
+double sphere(const double* x, int dim);
+double rastrigin(const double* x, int dim);
+double rosenbrock(const double* x, int dim);
+double ackley(const double* x, int dim);
+double griewank(const double* x, int dim);
+
+/**
+ * @brief A named test function, optionally shifted and rotated.
+ *
+ * Shifted and rotated variants evaluate f(R (x - o)) with a random shift o
+ * inside 80% of the search domain and a random orthogonal matrix R, both
+ * drawn from `seed`; the optimum moves to o (Rosenbrock is offset so its
+ * optimum does too). Rotation makes separable functions non-separable.
+ * Evaluation is thread-safe.
+ */
+class BenchmarkFunction {
+public:
+    /**
+     * @brief Construct a new Benchmark Function object.
+     *
+     * @param name One of names(): "sphere", "rastrigin", "rosenbrock", "ackley", "griewank".
+     * @param dim Dimensionality.
+     * @param shifted Move the optimum to a random point.
+     * @param rotated Apply a random rotation.
+     * @param seed Seed for the shift and rotation.
+     */
+    BenchmarkFunction(const std::string& name, int dim, bool shifted = false, bool rotated = false,
+                      uint64_t seed = 0);
+
+    /**
+     * @brief Evaluate one point of `dim` values.
+     */
+    double evaluate(const double* x) const;
+
+    double operator()(const std::vector<double>& x) const { return evaluate(x.data()); }
+
+    /**
+     * @brief Evaluate `count` points stored row-major; matches
+     *        BaseOptimizer::BatchObjectiveFunction.
+     */
+    void evaluate_batch(const double* positions, int count, int dim, double* fitness) const;
+
+    /**
+     * @brief C-style entry point for BaseOptimizer::set_native_objective(),
+     *        with a BenchmarkFunction as user data.
+     */
+    static double call(const double* x, std::size_t dim, void* function);
+
+    /**
+     * @brief A per-individual objective sharing this function's data, for
+     *        BaseOptimizer::set_objective().
+     */
+    std::function<double(const std::vector<double>&)> as_objective() const;
+
+    const std::string& get_name() const { return name; }
+    int get_dim() const { return dim; }
+
+    // Usual search domain, the same in every dimension.
+    double get_lower_bound() const { return lower_bound; }
+    double get_upper_bound() const { return upper_bound; }
+
+    /**
+     * @brief Location of the global minimum (whose value is 0).
+     */
+    std::vector<double> get_optimum() const;
+
+    /**
+     * @brief Names accepted by the constructor.
+     */
+    static const std::vector<std::string>& names();
+
+private:
+    using Kernel = double (*)(const double*, int);
+
+    std::string name;
+    int dim;
+    Kernel kernel;
+    double lower_bound;
+    double upper_bound;
+    double kernel_optimum;            // Optimum coordinate of the untransformed kernel.
+    std::vector<double> shift;        // Empty unless shifted.
+    std::vector<double> rotation;     // dim x dim row-major; empty unless rotated.
+};
+
+#endif // BENCHMARK_FUNCTIONS_H
@@ -0,0 +1,153 @@
+#ifndef BIOOPT_C_H
+#define BIOOPT_C_H
+
+/*
+ * C interface to the optimizers, for runtimes that cannot use the C++
+ * classes directly (C, Rust, Go, Julia, ...). Optimizers are opaque handles.
+ *
+ * Functions returning int return BIOOPT_OK on success and BIOOPT_ERROR on
+ * failure; bioopt_last_error() then describes the failure. No C++ exception
+ * crosses this interface.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Exported symbols, also under -fvisibility=hidden. On Windows the library
+ * is built with BIOOPT_BUILDING defined, and a static build passes
+ * BIOOPT_STATIC on to its consumers.
+ */
+#if defined(_WIN32)
+#if defined(BIOOPT_STATIC)
+#define BIOOPT_API
+#elif defined(BIOOPT_BUILDING)
+#define BIOOPT_API __declspec(dllexport)
+#else
+#define BIOOPT_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define BIOOPT_API __attribute__((visibility("default")))
+#else
+#define BIOOPT_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BIOOPT_OK 0
+#define BIOOPT_ERROR (-1)
+
+/* Values of bioopt_get_stop_reason(), in the order of StopReason. */
+#define BIOOPT_STOP_NOT_STOPPED 0
+#define BIOOPT_STOP_MAX_ITERATIONS 1
+#define BIOOPT_STOP_MAX_EVALUATIONS 2
+#define BIOOPT_STOP_DEADLINE 3
+#define BIOOPT_STOP_TARGET_REACHED 4
+#define BIOOPT_STOP_STAGNATION 5
+#define BIOOPT_STOP_DIVERSITY_COLLAPSE 6
+#define BIOOPT_STOP_CALLBACK 7
+
+/* Values of bioopt_set_precision(), in the order of Precision. */
+#define BIOOPT_FLOAT64 0
+#define BIOOPT_FLOAT32 1
+
+typedef struct bioopt_optimizer bioopt_optimizer;
+
+/* Objective: fitness of the `dim` values at x. Same as BaseOptimizer::NativeObjective. */
+typedef double (*bioopt_objective)(const double* x, size_t dim, void* user_data);
+
+/*
+ * Settings structs start with struct_size, which callers set to
+ * sizeof(the struct) so fields can be appended in later versions. Any
+ * struct_size that covers the fields below (up to min_diversity and
+ * min_points) is accepted; smaller ones are rejected. Fields appended later
+ * are read only when struct_size covers them, so older callers get their
+ * defaults, and a newer caller's extra fields are ignored by this library.
+ */
+
+/* Stopping rules; a zero value disables a rule. See TerminationCriteria. */
+typedef struct bioopt_termination {
+    size_t struct_size;
+    uint64_t max_evaluations;
+    double max_seconds;
+    int has_target;
+    double target_fitness;
+    int stagnation_window;
+    double stagnation_epsilon;
+    double min_diversity;
+} bioopt_termination;
+
+/* Surrogate pre-screening; capacity 0 disables it. See SurrogateSettings. */
+typedef struct bioopt_surrogate {
+    size_t struct_size;
+    int capacity;
+    int neighbors;
+    double evaluate_fraction;
+    double explore_fraction;
+    int min_points;
+} bioopt_surrogate;
+
+/* Message of the last failure on the calling thread ("" if none). */
+BIOOPT_API const char* bioopt_last_error(void);
+
+/* Constructors; NULL on failure. Release with bioopt_destroy(). */
+BIOOPT_API bioopt_optimizer* bioopt_pso_create(int num_individuals, int dim, double lower_bound, double upper_bound,
+                                               int max_iter, double c1, double c2, double w, int minimize, int seed);
+BIOOPT_API bioopt_optimizer* bioopt_sma_create(int num_individuals, int dim, double lower_bound, double upper_bound,
+                                               int max_iter, double c1, double c2, double w, int minimize, int seed);
+BIOOPT_API bioopt_optimizer* bioopt_ga_create(int num_individuals, int dim, double lower_bound, double upper_bound,
+                                              int max_iter, double crossover_rate, double mutation_rate, int minimize,
+                                              int seed);
+BIOOPT_API void bioopt_destroy(bioopt_optimizer* optimizer);
+
+/* Configuration. */
+BIOOPT_API int bioopt_set_objective(bioopt_optimizer* optimizer, bioopt_objective objective, void* user_data,
+                                    int thread_safe);
+BIOOPT_API int bioopt_set_num_threads(bioopt_optimizer* optimizer, int num_threads);
+BIOOPT_API int bioopt_set_fitness_cache(bioopt_optimizer* optimizer, int capacity);
+BIOOPT_API int bioopt_set_async_mode(bioopt_optimizer* optimizer, int enabled);
+BIOOPT_API int bioopt_set_termination(bioopt_optimizer* optimizer, const bioopt_termination* criteria);
+BIOOPT_API int bioopt_set_surrogate(bioopt_optimizer* optimizer, const bioopt_surrogate* settings);
+/* BIOOPT_FLOAT32 stores the population in single precision (PSO and SMA);
+ * objectives and bioopt_ask() still see double values. */
+BIOOPT_API int bioopt_set_precision(bioopt_optimizer* optimizer, int precision);
+
+/* Run `iterations` iterations (-1 for max_iter); resumes where the last call stopped. */
+BIOOPT_API int bioopt_optimize(bioopt_optimizer* optimizer, int iterations);
+
+/*
+ * Ask/tell: bioopt_ask() points *positions at the row-major candidates
+ * (valid until the next call on this optimizer); bioopt_tell() takes one
+ * fitness value per candidate. bioopt_get_candidate_rows() points *rows at
+ * the indices of the asked rows that need evaluating (valid until the next
+ * call); the others (GA elites and clones) keep their fitness, and
+ * bioopt_tell() ignores their values.
+ */
+BIOOPT_API int bioopt_ask(bioopt_optimizer* optimizer, const double** positions, int* rows, int* cols);
+BIOOPT_API int bioopt_get_candidate_rows(bioopt_optimizer* optimizer, const int** rows, int* count);
+BIOOPT_API int bioopt_tell(bioopt_optimizer* optimizer, const double* fitness, int count);
+
+/*
+ * Results. Given a NULL handle the getters set bioopt_last_error() and
+ * return NaN (best fitness), BIOOPT_ERROR (iteration, stop reason) or
+ * UINT64_MAX (counters).
+ */
+BIOOPT_API double bioopt_get_best_fitness(const bioopt_optimizer* optimizer);
+BIOOPT_API int bioopt_get_best_solution(const bioopt_optimizer* optimizer, double* solution, int dim);
+BIOOPT_API int bioopt_get_iteration(const bioopt_optimizer* optimizer);
+BIOOPT_API uint64_t bioopt_get_evaluation_count(const bioopt_optimizer* optimizer);
+BIOOPT_API uint64_t bioopt_get_evaluations_saved(const bioopt_optimizer* optimizer);
+BIOOPT_API int bioopt_get_stop_reason(const bioopt_optimizer* optimizer);
+BIOOPT_API const char* bioopt_stop_reason_name(int reason);
+
+/* Checkpoints, in the format of BaseOptimizer::save_checkpoint(). */
+BIOOPT_API int bioopt_save_checkpoint(const bioopt_optimizer* optimizer, const char* path);
+BIOOPT_API int bioopt_load_checkpoint(bioopt_optimizer* optimizer, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BIOOPT_C_H */
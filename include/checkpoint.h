@@ -0,0 +1,182 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed part of a checkpoint, stored in its first 64 bytes.
+ *
+ * On disk: magic "BIOCKPT\0", uint32 version, int32 max_iter, char[16]
+ * algorithm name, int32 num_individuals, int32 dim, double lower_bound,
+ * double upper_bound, uint64 payload bytes. The payload follows; arrays in
+ * it start on 8-byte boundaries so they can be read in place.
+ */
+struct CheckpointHeader {
+    uint32_t version = 0;
+    std::string algorithm;
+    int num_individuals = 0;
+    int dim = 0;
+    double lower_bound = 0.0;
+    double upper_bound = 0.0;
+    int max_iter = 0;
+};
+
+/**
+ * @brief Appends checkpoint fields to a byte buffer.
+ */
+class CheckpointWriter {
+public:
+    /**
+     * @brief Start a checkpoint with the given header.
+     */
+    explicit CheckpointWriter(const CheckpointHeader& header);
+
+    /**
+     * @brief Append one trivially copyable value.
+     */
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Checkpoint fields must be trivially copyable.");
+        append(&value, sizeof(T));
+    }
+
+    /**
+     * @brief Append an array as a uint64 count followed by the elements,
+     * starting on an 8-byte boundary.
+     */
+    template <typename T>
+    void write_array(const T* values, std::size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Checkpoint fields must be trivially copyable.");
+        align();
+        write(static_cast<uint64_t>(count));
+        append(values, count * sizeof(T));
+    }
+
+    template <typename T>
+    void write_array(const std::vector<T>& values) { write_array(values.data(), values.size()); }
+
+    /**
+     * @brief Finish the checkpoint: fill in the payload size and return the bytes.
+     */
+    std::vector<unsigned char>& finish();
+
+private:
+    std::vector<unsigned char> bytes;
+
+    void append(const void* data, std::size_t size);
+    void align();
+};
+
+/**
+ * @brief Reads checkpoint fields in place from a byte range (for example a
+ * memory-mapped file). Every read is bounds-checked.
+ */
+class CheckpointReader {
+public:
+    /**
+     * @brief Check the header and position the reader at the start of the payload.
+     */
+    CheckpointReader(const unsigned char* data, std::size_t size);
+
+    const CheckpointHeader& header() const { return head; }
+
+    // Bytes left to read.
+    std::size_t remaining() const { return static_cast<std::size_t>(end - pos); }
+
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value, "Checkpoint fields must be trivially copyable.");
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    /**
+     * @brief Read an array written by write_array(), which must hold `count`
+     * elements. Returns a pointer into the underlying bytes.
+     */
+    template <typename T>
+    const T* read_array(std::size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Checkpoint fields must be trivially copyable.");
+        align();
+        if (read<uint64_t>() != count) {
+            throw std::runtime_error("Checkpoint array has an unexpected size.");
+        }
+        return reinterpret_cast<const T*>(take(count * sizeof(T)));
+    }
+
+    /**
+     * @brief Read an array of `count` elements into `out`.
+     */
+    template <typename T>
+    void read_into(T* out, std::size_t count) {
+        const T* values = read_array<T>(count);
+        if (count > 0) {
+            std::memcpy(out, values, count * sizeof(T));
+        }
+    }
+
+    template <typename T>
+    void read_into(std::vector<T>& out) { read_into(out.data(), out.size()); }
+
+    /**
+     * @brief Read an array of any length written by write_array().
+     */
+    template <typename T>
+    std::vector<T> read_vector() {
+        align();
+        uint64_t count = read<uint64_t>();
+        if (count > remaining() / sizeof(T)) {
+            throw std::runtime_error("Checkpoint is truncated or corrupt.");
+        }
+        const unsigned char* values = take(static_cast<std::size_t>(count) * sizeof(T));
+        std::vector<T> out(static_cast<std::size_t>(count));
+        if (count > 0) {
+            std::memcpy(out.data(), values, out.size() * sizeof(T));
+        }
+        return out;
+    }
+
+private:
+    const unsigned char* base;
+    std::size_t pos;
+    std::size_t end;
+    CheckpointHeader head;
+
+    const unsigned char* take(std::size_t size);
+    void align();
+};
+
+/**
+ * @brief Read-only view of a whole file, memory-mapped where supported.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+    const unsigned char* bytes = nullptr;
+    std::size_t length = 0;
+    std::vector<unsigned char> fallback;  // Used where mmap is unavailable.
+};
+
+/**
+ * @brief Write `bytes` to `path` through a temporary file and a rename, so an
+ * interrupted save never leaves a partial checkpoint behind.
+ */
+void write_file_atomically(const std::string& path, const std::vector<unsigned char>& bytes);
+
+#endif // CHECKPOINT_H
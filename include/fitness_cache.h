@@ -0,0 +1,79 @@
+#ifndef FITNESS_CACHE_H
+#define FITNESS_CACHE_H
+
+#include "checkpoint.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Bounded cache of fitness values keyed on the exact bits of a genome.
+ *
+ * Genomes are compared bit for bit, so a hit always returns the value the
+ * objective produced for that very input. When full, the oldest entry is
+ * evicted (first in, first out). Not thread-safe: the optimizer looks up and
+ * inserts serially around the (possibly parallel) objective calls.
+ */
+class FitnessCache {
+public:
+    /**
+     * @brief Drop all entries and set the capacity.
+     *
+     * @param capacity Maximum number of entries (0 disables the cache).
+     * @param dim Values per genome.
+     */
+    void configure(int capacity, int dim);
+
+    bool enabled() const { return capacity > 0; }
+    int get_capacity() const { return capacity; }
+    int size() const { return static_cast<int>(index.size()); }
+
+    /**
+     * @brief Look up a genome, counting a hit or a miss.
+     *
+     * @param genome `dim` values.
+     * @param fitness Set to the cached value on a hit.
+     * @return true if the genome was found.
+     */
+    bool lookup(const double* genome, double& fitness);
+
+    /**
+     * @brief Insert (or refresh) the fitness of a genome.
+     */
+    void insert(const double* genome, double fitness);
+
+    uint64_t get_hits() const { return hits; }
+    uint64_t get_misses() const { return misses; }
+
+    /**
+     * @brief Write the capacity, entries and counters to a checkpoint.
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * @brief Restore what save() wrote, for genomes of `dim` values.
+     */
+    void load(CheckpointReader& in, int dim);
+
+private:
+    int capacity = 0;
+    int dim = 0;
+    int next_slot = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    // Slot storage: genome bits, fitness and hash of each entry.
+    std::vector<double> genomes;
+    std::vector<double> values;
+    std::vector<uint64_t> hashes;
+    std::vector<bool> used;
+
+    // Genome hash -> slot.
+    std::unordered_map<uint64_t, int> index;
+
+    uint64_t hash(const double* genome) const;
+    bool matches(int slot, const double* genome) const;
+};
+
+#endif // FITNESS_CACHE_H
@@ -2,9 +2,9 @@
 #define GA_H
 
 #include "base_optimizer.h"
+#include "policies.h"
 #include <vector>
 #include <functional>
-#include <random>
 
 /**
  * @brief Genetic Algorithm (GA) optimizer with extra configurable parameters.
@@ -51,25 +51,30 @@ public:
     virtual ~GA() {}
 
     // Base class overrides with snake_case names.
-    void set_objective(std::function<double(const std::vector<double>&)> obj) override;
-    void optimize(int iterations) override;
-    std::vector<double> get_best_solution() const override;
+    const std::vector<double>& get_best_solution() const override;
     double get_best_fitness() const override;
+    const Population& get_population() const override;
+    const std::vector<double>& get_fitness() const override;
+    const std::vector<int>* candidate_rows() const override;
 
-    /**
-     * @brief Retrieve the population history.
-     *
-     * @return std::vector<std::vector<std::vector<double>>> Population history.
-     */
-    std::vector<std::vector<std::vector<double>>> get_population_history() const;
+protected:
+    // Stepping hooks driven by BaseOptimizer.
+    std::vector<double>& fitness_buffer() override;
+    void absorb_initial() override;
+    void generate() override;
+    void settle_population() override;
+    void absorb() override;
+    void evaluate_candidates() override;
+    void replace_individual(int i, const double* genome, double fitness) override;
+    const char* algorithm_name() const override { return "GA"; }
+    void save_state(CheckpointWriter& out) const override;
+    void load_state(CheckpointReader& in) override;
+    bool supports_async() const override { return true; }
+    int propose_async(double* candidate) override;
+    void accept_async(int slot, const double* candidate, double fitness) override;
 
 private:
-    std::function<double(const std::vector<double>&)> objective_function;
-
     // GA configuration parameters.
-    int max_iter;
-    bool minimize;
-    bool verbose;
     double crossover_rate;
     double mutation_rate;
     int tournament_size;
@@ -77,28 +82,47 @@ private:
     bool use_uniform_crossover;
     bool use_gaussian_mutation;
     double mutation_std;
-    bool store_history_each_iter;
 
-    std::mt19937 rng;
-
-    // Population data.
-    std::vector<std::vector<double>> population;
+    // Population data. `new_population` is the back buffer children are bred
+    // into; the two are swapped every generation, and settle_population()
+    // hands the original storage back to `population`.
+    Population population;
+    Population new_population;
+    bool buffers_swapped = false;
     std::vector<double> fitness;
 
+    // Per-generation scratch, allocated once.
+    std::vector<int> mating_pool;  // Population index of each selected parent.
+    std::vector<int> ranking;      // Individual indices, elites first.
+    std::vector<int> source;       // Parent a row is an exact copy of, or -1.
+    std::vector<double> carried_fitness;
+    std::vector<int> changed_rows; // Rows that need evaluating.
+
     // Global best solution and fitness.
     std::vector<double> best_solution;
     double best_fitness;
 
-    // Population history.
-    std::vector<std::vector<std::vector<double>>> population_history;
+    // Specializations for the current direction and operators, picked by select_kernels().
+    void (GA::*generate_fn)() = nullptr;
+    void (GA::*update_best_fn)() = nullptr;
 
     // Helper methods.
     void initialize_population();
-    void evaluate_population();
-    std::vector<std::vector<double>> selection();
-    std::vector<double> crossover(const std::vector<double>& parent1, const std::vector<double>& parent2);
-    void mutate(std::vector<double>& individual);
-    void enforce_bounds(std::vector<double>& individual);
+    void select_kernels();
+    void update_best();
+    int tournament(RandomStream& stream) const;
+    void crossover(const double* parent1, const double* parent2, double* offspring, RandomStream& stream);
+    bool mutate(double* individual, RandomStream& stream);
+    void enforce_bounds(double* individual);
+
+    // Policy-specialized bodies of generate() and the helpers above.
+    template <typename Direction, bool Uniform, bool Gaussian> void generate_with();
+    template <typename Direction> void update_best_with();
+    template <typename Direction> void selection_with();
+    template <typename Direction> int tournament_with(RandomStream& stream) const;
+    template <bool Uniform>
+    void crossover_with(const double* parent1, const double* parent2, double* offspring, RandomStream& stream);
+    template <bool Gaussian> bool mutate_with(double* individual, RandomStream& stream);
 };
 
 #endif // GA_H
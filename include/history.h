@@ -0,0 +1,253 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "population.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief How population history is recorded.
+ */
+struct HistoryOptions {
+    // Snapshots kept in memory: -1 keeps all of them, 0 keeps none (spill only),
+    // K > 0 keeps the last K.
+    int capacity = -1;
+    // Record every stride-th generation (generation 0 is the initial population).
+    int stride = 1;
+    // If false, only fitness, best fitness and generation are recorded.
+    bool record_positions = true;
+    // If not empty, every recorded snapshot is also appended to this file.
+    std::string spill_path;
+};
+
+/**
+ * @brief Read-only window into one history track.
+ *
+ * `buffer` keeps the memory alive; `data` points at the oldest snapshot
+ * still held (nullptr when the track is empty).
+ */
+template <typename T>
+struct HistorySlice {
+    std::shared_ptr<const std::vector<T>> buffer;
+    const T* data = nullptr;
+    int size = 0;
+};
+
+/**
+ * @brief Fixed-width snapshots stored back to back, optionally as a ring.
+ *
+ * The live snapshots are always one contiguous run of the buffer. In bounded
+ * mode the buffer has room for 2 x capacity snapshots: new snapshots go after
+ * the live run and, once the end is reached, the run slides back to the
+ * front. Memory already covered by a handed-out slice is never written again;
+ * if the buffer is shared when it would be, a fresh buffer is used instead.
+ */
+template <typename T>
+class HistoryTrack {
+public:
+    /**
+     * @brief Drop all snapshots and set the snapshot width and capacity.
+     */
+    void reset(std::size_t snapshot_width, int max_snapshots) {
+        values.reset();
+        width = snapshot_width;
+        capacity = max_snapshots;
+        start = 0;
+        count = 0;
+    }
+
+    /**
+     * @brief Append one snapshot of `width` values, evicting the oldest if full.
+     */
+    void push(const T* snapshot) {
+        if (capacity == 0 || width == 0) {
+            return;
+        }
+        if (capacity > 0 && count == capacity) {
+            ++start;
+            --count;
+        }
+        std::size_t used = static_cast<std::size_t>(count) * width;
+        if (capacity > 0) {
+            std::size_t limit = 2 * static_cast<std::size_t>(capacity) * width;
+            if (!values) {
+                relocate(limit);
+            } else if (values->size() + width > limit) {
+                if (values.use_count() == 1) {
+                    std::copy(values->begin() + start * width, values->end(), values->begin());
+                    values->resize(used);
+                    start = 0;
+                } else {
+                    relocate(limit);
+                }
+            }
+        } else if (!values || values->capacity() < values->size() + width) {
+            relocate(std::max(used + width, values ? values->capacity() * 2 : used + width));
+        }
+        values->insert(values->end(), snapshot, snapshot + width);
+        ++count;
+    }
+
+    int size() const { return count; }
+
+    HistorySlice<T> slice() const {
+        HistorySlice<T> out;
+        if (values && count > 0) {
+            out.buffer = values;
+            out.data = values->data() + start * width;
+            out.size = count;
+        }
+        return out;
+    }
+
+private:
+    std::shared_ptr<std::vector<T>> values;
+    std::size_t width = 0;
+    int capacity = -1;
+    std::size_t start = 0;
+    int count = 0;
+
+    // Move the live snapshots into a new buffer with room for `reserve` values.
+    void relocate(std::size_t reserve) {
+        auto fresh = std::make_shared<std::vector<T>>();
+        fresh->reserve(reserve);
+        if (values) {
+            fresh->assign(values->begin() + start * width, values->end());
+        }
+        values = fresh;
+        start = 0;
+    }
+};
+
+/**
+ * @brief Streams history snapshots into a memory-mapped binary file.
+ *
+ * File layout (native byte order):
+ *   64-byte header: char magic[8] = "BIOHIST", uint32 version, uint32 flags
+ *   (bit 0 = positions present), int32 rows, int32 cols, uint64 count.
+ *   `count` records of: int64 generation, double best_fitness,
+ *   double fitness[rows], then double positions[rows][cols] if present.
+ * The header count is updated after each record, so the file can be read
+ * while a run is still going.
+ */
+class HistorySpill {
+public:
+    /**
+     * @brief Create (or truncate) the spill file.
+     *
+     * @param path File to write.
+     * @param rows Individuals per snapshot.
+     * @param cols Values per individual.
+     * @param positions If true, records include the population positions.
+     */
+    HistorySpill(const std::string& path, int rows, int cols, bool positions);
+    ~HistorySpill();
+
+    HistorySpill(const HistorySpill&) = delete;
+    HistorySpill& operator=(const HistorySpill&) = delete;
+
+    /**
+     * @brief Append one record.
+     */
+    void write(int64_t generation, double best_fitness, const double* fitness, const double* positions);
+
+    uint64_t size() const { return count; }
+
+private:
+    int fd = -1;
+    unsigned char* mapped = nullptr;
+    std::size_t mapped_bytes = 0;
+    std::size_t record_bytes = 0;
+    std::size_t fitness_count = 0;
+    std::size_t position_count = 0;
+    uint64_t count = 0;
+
+    void map(std::size_t bytes);
+};
+
+/**
+ * @brief Recorded optimizer trajectory.
+ *
+ * Each snapshot holds the generation number, the best fitness so far, the
+ * fitness of every individual and, unless disabled, the population positions.
+ * Snapshots can be thinned with a stride, bounded to the most recent ones,
+ * and streamed to disk. Every track is exposed as a zero-copy slice whose
+ * memory stays valid after later snapshots are recorded.
+ */
+class History {
+public:
+    /**
+     * @brief Drop all snapshots and set the snapshot shape.
+     *
+     * @param rows Individuals per snapshot.
+     * @param cols Values per individual.
+     */
+    void reset(int rows, int cols);
+
+    /**
+     * @brief Change how snapshots are recorded, dropping the current ones.
+     *
+     * Any open spill file is finalized first.
+     */
+    void configure(const HistoryOptions& options);
+
+    const HistoryOptions& get_options() const { return options; }
+
+    /**
+     * @brief Whether the stride selects this generation.
+     */
+    bool due(uint64_t generation) const { return generation % options.stride == 0; }
+
+    /**
+     * @brief Record one snapshot.
+     */
+    void record(const Population& population, const std::vector<double>& fitness,
+                double best_fitness, uint64_t generation);
+
+    /**
+     * @brief Record one snapshot of a float32 population, widened to double.
+     */
+    void record(const Population32& population, const std::vector<double>& fitness,
+                double best_fitness, uint64_t generation);
+
+    /**
+     * @brief Snapshots currently held in memory.
+     */
+    int size() const { return generations.size(); }
+    int rows() const { return num_rows; }
+    int cols() const { return num_cols; }
+
+    /**
+     * @brief Snapshots written to the spill file (0 without one).
+     */
+    uint64_t spilled() const { return spill ? spill->size() : 0; }
+
+    HistorySlice<double> get_positions() const { return positions.slice(); }
+    HistorySlice<double> get_fitness() const { return fitness_values.slice(); }
+    HistorySlice<double> get_best_fitness() const { return best_values.slice(); }
+    HistorySlice<int64_t> get_generations() const { return generations.slice(); }
+
+    /**
+     * @brief Copy the position snapshots out as nested vectors [snapshot][individual][value].
+     */
+    std::vector<std::vector<std::vector<double>>> to_vectors() const;
+
+private:
+    HistoryOptions options;
+    int num_rows = 0;
+    int num_cols = 0;
+    HistoryTrack<double> positions;
+    HistoryTrack<double> fitness_values;
+    HistoryTrack<double> best_values;
+    HistoryTrack<int64_t> generations;
+    std::unique_ptr<HistorySpill> spill;
+    Population widened;  // Scratch for float32 snapshots.
+
+    void clear();
+};
+
+#endif // HISTORY_H
@@ -0,0 +1,110 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Parts of an iteration that are timed separately.
+ */
+enum class Phase {
+    Evaluation,  // Objective calls, including fitness cache lookups.
+    Update,      // Moving the population (PSO/SMA kernels, GA breeding, best tracking).
+    Selection,   // GA tournament selection and elite ranking.
+    Bounds,      // Bound enforcement done as its own pass (GA).
+    History,     // Recording history snapshots.
+    Count
+};
+
+const int PHASE_COUNT = static_cast<int>(Phase::Count);
+
+/**
+ * @brief Human-readable name of a phase.
+ */
+const char* phase_name(Phase phase);
+
+/**
+ * @brief Per-phase timers and per-iteration statistics of one optimizer.
+ *
+ * Everything is off by default and costs one branch per phase when off.
+ * Phase times are exclusive: a phase timed inside another is subtracted from
+ * the outer one, so the totals add up to the instrumented time.
+ */
+class Instrumentation {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Turn collection on or off and drop what was collected.
+     *
+     * @param timers Time each phase.
+     * @param statistics Record best fitness, mean fitness, diversity and the
+     *        evaluation count after every iteration.
+     */
+    void configure(bool timers, bool statistics);
+
+    /**
+     * @brief Drop everything collected so far, keeping the settings.
+     */
+    void reset();
+
+    bool timing() const { return timers_on; }
+    bool collecting() const { return statistics_on; }
+
+    /**
+     * @brief Make room for `count` more iterations of statistics, so the
+     *        arrays do not reallocate inside the loop.
+     */
+    void reserve(std::size_t count);
+
+    /**
+     * @brief Append one iteration's statistics.
+     */
+    void record(int iteration, double best, double mean, double diversity, uint64_t evaluations);
+
+    const std::array<double, PHASE_COUNT>& get_phase_seconds() const { return phase_seconds; }
+    const std::array<uint64_t, PHASE_COUNT>& get_phase_calls() const { return phase_calls; }
+
+    const std::vector<int>& get_iterations() const { return iterations; }
+    const std::vector<double>& get_best() const { return best_fitness; }
+    const std::vector<double>& get_mean() const { return mean_fitness; }
+    const std::vector<double>& get_diversity() const { return diversity; }
+    const std::vector<uint64_t>& get_evaluations() const { return evaluations; }
+
+    /**
+     * @brief Times one phase for as long as it is in scope (no-op when timers are off).
+     */
+    class Scope {
+    public:
+        Scope(Instrumentation& owner, Phase phase);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Instrumentation* owner;
+        Phase phase;
+        Phase parent;
+        Clock::time_point start;
+    };
+
+private:
+    bool timers_on = false;
+    bool statistics_on = false;
+
+    std::array<double, PHASE_COUNT> phase_seconds{};
+    std::array<uint64_t, PHASE_COUNT> phase_calls{};
+    Phase active = Phase::Count;  // Innermost running phase (Count = none).
+
+    std::vector<int> iterations;
+    std::vector<double> best_fitness;
+    std::vector<double> mean_fitness;
+    std::vector<double> diversity;
+    std::vector<uint64_t> evaluations;
+};
+
+#endif // INSTRUMENTATION_H
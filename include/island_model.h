@@ -0,0 +1,123 @@
+#ifndef ISLAND_MODEL_H
+#define ISLAND_MODEL_H
+
+#include "base_optimizer.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Which islands send migrants to which.
+ */
+enum class MigrationTopology {
+    Ring,           // Island k sends to island k + 1 (wrapping around).
+    FullyConnected  // Every island sends to every other island.
+};
+
+/**
+ * @brief Migrants sent from one island to another in one exchange.
+ */
+struct MigrantPacket {
+    std::vector<double> genomes;  // count x dim, row-major.
+    std::vector<double> fitness;
+};
+
+/**
+ * @brief Single-slot mailbox between two islands.
+ *
+ * Lock-free: posting swaps a new packet in (dropping an unread older one) and
+ * taking swaps the slot empty, so each packet has exactly one owner at a time
+ * and neither side ever waits.
+ */
+class Mailbox {
+public:
+    Mailbox() = default;
+    ~Mailbox() { delete slot.exchange(nullptr); }
+
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+
+    void post(std::unique_ptr<MigrantPacket> packet) {
+        delete slot.exchange(packet.release(), std::memory_order_acq_rel);
+    }
+
+    std::unique_ptr<MigrantPacket> take() {
+        return std::unique_ptr<MigrantPacket>(slot.exchange(nullptr, std::memory_order_acq_rel));
+    }
+
+private:
+    std::atomic<MigrantPacket*> slot{nullptr};
+};
+
+/**
+ * @brief Runs several optimizers ("islands") side by side, one thread each,
+ * with periodic migration of elites between them.
+ *
+ * Islands may be any mix of BaseOptimizer subclasses sharing the same
+ * dimension and optimization direction. Every `migration_interval`
+ * iterations an island posts copies of its best individuals to its
+ * neighbours and takes in whatever has arrived from them; islands never wait
+ * for each other, so migration timing depends on thread scheduling.
+ */
+class IslandModel {
+public:
+    /**
+     * @brief Construct a new Island Model object.
+     *
+     * @param topology Migration topology.
+     * @param migration_interval Iterations between migrations.
+     * @param num_migrants Number of elites sent per migration.
+     * @param pin_threads If true, pin each island thread to its own CPU,
+     *        spreading islands round-robin over NUMA nodes.
+     */
+    IslandModel(MigrationTopology topology = MigrationTopology::Ring,
+                int migration_interval = 10,
+                int num_migrants = 1,
+                bool pin_threads = false);
+
+    /**
+     * @brief Add an island. The optimizer is not owned and must outlive the model.
+     */
+    void add_island(BaseOptimizer* island);
+
+    int size() const { return static_cast<int>(islands.size()); }
+
+    BaseOptimizer& get_island(int k) const { return *islands.at(k); }
+
+    /**
+     * @brief Run every island for `iterations` iterations, migrating in between.
+     *
+     * Each island makes this one run (begin_run() to end_run()), so its
+     * stopping rules, max_seconds included, apply to the whole call rather
+     * than to each migration interval.
+     *
+     * @param iterations Iterations per island.
+     */
+    void optimize(int iterations);
+
+    /**
+     * @brief Index of the island holding the best solution found.
+     */
+    int get_best_island() const;
+
+    const std::vector<double>& get_best_solution() const;
+    double get_best_fitness() const;
+
+    /**
+     * @brief Number of migrant packets taken in so far, over all islands.
+     */
+    uint64_t get_migrations() const { return migrations.load(); }
+
+private:
+    MigrationTopology topology;
+    int migration_interval;
+    int num_migrants;
+    bool pin_threads;
+    std::vector<BaseOptimizer*> islands;
+    std::atomic<uint64_t> migrations{0};
+
+    void run_island(int k, int iterations, std::vector<Mailbox>& boxes, std::atomic<bool>& stop);
+};
+
+#endif // ISLAND_MODEL_H
@@ -0,0 +1,137 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+/**
+ * @brief Coefficients shared by every row of one PSO update step.
+ */
+struct PSOUpdateParams {
+    double w;
+    double c1;
+    double c2;
+    double v_max;        // 0.0 disables velocity clamping.
+    double lower_bound;
+    double upper_bound;
+};
+
+/**
+ * @brief Coefficients shared by every row of one SMA update step.
+ */
+struct SMAUpdateParams {
+    double c1;
+    double c2;
+    double w;
+    double lower_bound;
+    double upper_bound;
+};
+
+/**
+ * @brief Fused PSO update for one particle.
+ *
+ * In a single pass over the row: updates the velocity from the personal and
+ * neighborhood/global best, clamps it to v_max, moves the position and clamps
+ * it to the bounds. The widest instruction set available at runtime
+ * (AVX-512, AVX2 or scalar) is selected on first use; all paths round
+ * identically, so results do not depend on the machine.
+ *
+ * @param params Update coefficients.
+ * @param dim Row length.
+ * @param position Particle position, updated in place.
+ * @param velocity Particle velocity, updated in place.
+ * @param pbest Personal best position.
+ * @param best Neighborhood or global best position.
+ * @param r1 Cognitive random factors in [0, 1), one per dimension.
+ * @param r2 Social random factors in [0, 1), one per dimension.
+ */
+void pso_update_row(const PSOUpdateParams& params, int dim,
+                    double* position, double* velocity,
+                    const double* pbest, const double* best,
+                    const double* r1, const double* r2);
+
+/**
+ * @brief Fused SMA update for one agent.
+ *
+ * In a single pass over the row: scales the random factors, computes the
+ * step toward the best position, applies the inertia weight and clamps the
+ * result to the bounds. Dispatched the same way as pso_update_row.
+ *
+ * @param params Update coefficients.
+ * @param dim Row length.
+ * @param position Agent position, updated in place.
+ * @param best Best position found so far.
+ * @param r1 Attraction random factors in [0, 1), one per dimension.
+ * @param r2 Variation random factors in [0, 1), one per dimension.
+ */
+void sma_update_row(const SMAUpdateParams& params, int dim,
+                    double* position, const double* best,
+                    const double* r1, const double* r2);
+
+/**
+ * @brief Signatures of pso_update_row and sma_update_row, for kernels picked
+ *        once up front with select_pso_kernel() and select_sma_kernel().
+ */
+using PSOKernel = void (*)(const PSOUpdateParams& params, int dim,
+                           double* position, double* velocity,
+                           const double* pbest, const double* best,
+                           const double* r1, const double* r2);
+using SMAKernel = void (*)(const SMAUpdateParams& params, int dim,
+                           double* position, const double* best,
+                           const double* r1, const double* r2);
+
+// Largest row length with its own fully unrolled kernels.
+const int MAX_FIXED_KERNEL_DIM = 16;
+
+/**
+ * @brief PSO row update specialized for one configuration.
+ *
+ * Combines the runtime instruction-set choice with compile-time variants:
+ * for dim <= MAX_FIXED_KERNEL_DIM the row length is a template constant, so
+ * the loop is fully unrolled, and velocity clamping is compiled in or out.
+ * The result matches pso_update_row bit for bit, but params.v_max is only
+ * honored if `clamp_velocity` was true, and `dim` must not change.
+ *
+ * @param dim Row length the kernel will be called with.
+ * @param clamp_velocity Whether params.v_max > 0.0.
+ */
+PSOKernel select_pso_kernel(int dim, bool clamp_velocity);
+
+/**
+ * @brief SMA row update specialized for one row length, as select_pso_kernel().
+ */
+SMAKernel select_sma_kernel(int dim);
+
+/**
+ * @brief Single-precision kernels for float32 populations.
+ *
+ * The same updates as PSOKernel and SMAKernel on float rows, with the
+ * coefficients rounded to float. Vector paths process twice as many
+ * elements per instruction (16 with AVX-512, 8 with AVX2) and, as with
+ * double, round exactly like the scalar path.
+ */
+using PSOKernel32 = void (*)(const PSOUpdateParams& params, int dim,
+                             float* position, float* velocity,
+                             const float* pbest, const float* best,
+                             const float* r1, const float* r2);
+using SMAKernel32 = void (*)(const SMAUpdateParams& params, int dim,
+                             float* position, const float* best,
+                             const float* r1, const float* r2);
+
+/**
+ * @brief Single-precision PSO row update for the runtime instruction set.
+ *
+ * @param clamp_velocity Whether params.v_max > 0.0; v_max is ignored otherwise.
+ */
+PSOKernel32 select_pso_kernel32(bool clamp_velocity);
+
+/**
+ * @brief Single-precision SMA row update for the runtime instruction set.
+ */
+SMAKernel32 select_sma_kernel32();
+
+/**
+ * @brief Name of the instruction set picked by the runtime dispatch.
+ *
+ * @return const char* "avx512", "avx2" or "scalar".
+ */
+const char* kernel_isa();
+
+#endif // KERNELS_H
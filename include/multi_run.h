@@ -0,0 +1,105 @@
+#ifndef MULTI_RUN_H
+#define MULTI_RUN_H
+
+#include "base_optimizer.h"
+#include "population.h"
+#include "thread_pool.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Steps many independent optimizer runs together.
+ *
+ * Meant for seed and hyperparameter sweeps: runs may be any mix of
+ * BaseOptimizer subclasses and settings sharing one dimension. Every step,
+ * the runs generate their candidates in parallel, the candidates of all
+ * runs are gathered into one contiguous block, and the block is evaluated
+ * at once (a single call for a batch objective, or spread over the worker
+ * threads for a native one) before each run takes in its fitness values.
+ *
+ * Each run goes exactly as optimize() would take it with the same
+ * objective, including its own stopping rules; runs that stop drop out of
+ * later steps. Runs are stepped generationally, whatever their async mode,
+ * and their own objectives, fitness caches, surrogates and thread counts
+ * are not used.
+ */
+class MultiRun {
+public:
+    /**
+     * @brief Construct a new Multi Run object.
+     *
+     * @param num_threads Threads stepping runs and evaluating native
+     *        objectives (1 = serial, 0 = hardware concurrency).
+     */
+    explicit MultiRun(int num_threads = 1);
+
+    /**
+     * @brief Add a run. The optimizer is not owned and must outlive the runner.
+     */
+    void add_run(BaseOptimizer* run);
+
+    int size() const { return static_cast<int>(runs.size()); }
+
+    BaseOptimizer& get_run(int k) const { return *runs.at(k); }
+
+    /**
+     * @brief Set the objective evaluating every candidate of every run.
+     *
+     * Called once per step with the rows of all runs still going, run after
+     * run, in row-major order.
+     */
+    void set_batch_objective(BaseOptimizer::BatchObjectiveFunction obj);
+
+    /**
+     * @brief Set a plain C function as the objective, as BaseOptimizer::set_native_objective().
+     */
+    void set_native_objective(BaseOptimizer::NativeObjective fn, void* user_data = nullptr,
+                              bool thread_safe = true, std::shared_ptr<const void> owner = nullptr);
+
+    /**
+     * @brief Set the number of threads (1 = serial, 0 = hardware concurrency).
+     */
+    void set_num_threads(int num_threads);
+
+    int get_num_threads() const { return thread_pool ? thread_pool->size() : 1; }
+
+    /**
+     * @brief Run every run for `iterations` iterations, or until its stopping rules end it.
+     *
+     * Like optimize(), the first call also evaluates the initial
+     * populations and later calls resume where the previous one stopped.
+     *
+     * @param iterations Iterations per run (-1 for each run's max_iter).
+     */
+    void optimize(int iterations);
+
+    /**
+     * @brief Per-run results, in the order the runs were added.
+     */
+    std::vector<double> get_best_fitness() const;
+    std::vector<double> get_best_solutions() const;  // size() x dim, row-major.
+    std::vector<int> get_iterations() const;
+    std::vector<uint64_t> get_evaluation_counts() const;
+    std::vector<StopReason> get_stop_reasons() const;
+
+private:
+    std::vector<BaseOptimizer*> runs;
+    std::unique_ptr<ThreadPool> thread_pool;
+
+    BaseOptimizer::BatchObjectiveFunction batch_objective_function;
+    BaseOptimizer::NativeObjective native_objective = nullptr;
+    void* native_user_data = nullptr;
+    std::shared_ptr<const void> native_owner;
+    bool objective_thread_safe = true;
+
+    // Candidates of the active runs, back to back, and their fitness.
+    Population block;
+    std::vector<double> block_fitness;
+    std::vector<std::vector<double>> told; // Whole-population fitness per run.
+
+    void parallel_for(int count, const std::function<void(int, int)>& body);
+    void evaluate_block(int rows);
+};
+
+#endif // MULTI_RUN_H
@@ -0,0 +1,20 @@
+#ifndef POLICIES_H
+#define POLICIES_H
+
+#include <limits>
+
+// Optimization direction as a type. Hot loops are instantiated once per
+// direction and picked when an optimizer is built, so they compare fitness
+// values without testing `minimize` on every comparison.
+
+struct Minimize {
+    static bool better(double a, double b) { return a < b; }
+    static double worst() { return std::numeric_limits<double>::max(); }
+};
+
+struct Maximize {
+    static bool better(double a, double b) { return a > b; }
+    static double worst() { return std::numeric_limits<double>::lowest(); }
+};
+
+#endif // POLICIES_H
@@ -0,0 +1,208 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Allocator returning memory aligned for wide vector loads.
+ */
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+/**
+ * @brief Non-owning view of one row of a population.
+ */
+template <typename T>
+class RowSpan {
+public:
+    RowSpan(T* data, int size) : ptr(data), count(size) {}
+
+    T* data() const { return ptr; }
+    int size() const { return count; }
+    T& operator[](int d) const { return ptr[d]; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + count; }
+
+private:
+    T* ptr;
+    int count;
+};
+
+/**
+ * @brief Precision of the population storage and of the update kernels.
+ *
+ * Fitness values and the best solution are double in both modes.
+ */
+enum class Precision {
+    Float64,
+    Float32
+};
+
+/**
+ * @brief Human-readable name of a precision.
+ */
+inline const char* precision_name(Precision precision) {
+    return precision == Precision::Float32 ? "float32" : "float64";
+}
+
+/**
+ * @brief Population stored as a single contiguous, row-major N x dim buffer.
+ *
+ * Each individual is one row. The buffer is 64-byte aligned and rows are
+ * packed back to back, so the whole population can be handed to a batch
+ * objective or a vectorized kernel without any copying.
+ */
+template <typename T>
+class BasicPopulation {
+public:
+    BasicPopulation() = default;
+
+    /**
+     * @brief Construct a new Population object.
+     *
+     * @param rows Number of individuals.
+     * @param cols Number of values per individual.
+     * @param value Initial value for every element.
+     */
+    BasicPopulation(int rows, int cols, T value = T()) { resize(rows, cols, value); }
+
+    /**
+     * @brief Resize the population, discarding its contents.
+     */
+    void resize(int rows, int cols, T value = T()) {
+        num_rows = rows;
+        num_cols = cols;
+        values.assign(static_cast<std::size_t>(rows) * cols, value);
+    }
+
+    /**
+     * @brief Empty the population and give its memory back.
+     */
+    void release() {
+        num_rows = 0;
+        num_cols = 0;
+        std::vector<T, AlignedAllocator<T>>().swap(values);
+    }
+
+    int rows() const { return num_rows; }
+    int cols() const { return num_cols; }
+    std::size_t size() const { return values.size(); }
+
+    T* data() { return values.data(); }
+    const T* data() const { return values.data(); }
+
+    RowSpan<T> row(int i) { return RowSpan<T>(values.data() + offset(i), num_cols); }
+    RowSpan<const T> row(int i) const { return RowSpan<const T>(values.data() + offset(i), num_cols); }
+
+    /**
+     * @brief Exchange contents with another population without copying.
+     */
+    void swap(BasicPopulation& other) noexcept {
+        std::swap(num_rows, other.num_rows);
+        std::swap(num_cols, other.num_cols);
+        values.swap(other.values);
+    }
+
+    /**
+     * @brief Copy row `src_row` of `src` into row `dst_row` of this population.
+     */
+    void copy_row(int dst_row, const BasicPopulation& src, int src_row) {
+        const T* from = src.values.data() + src.offset(src_row);
+        std::copy(from, from + num_cols, values.data() + offset(dst_row));
+    }
+
+    /**
+     * @brief Copy the contents of a population of the same shape, converting
+     *        each value to T.
+     */
+    template <typename U>
+    void assign_from(const BasicPopulation<U>& src) {
+        if (num_rows != src.rows() || num_cols != src.cols()) {
+            resize(src.rows(), src.cols());
+        }
+        std::copy(src.data(), src.data() + src.size(), values.data());
+    }
+
+    /**
+     * @brief Copy a single row out as a std::vector.
+     */
+    std::vector<double> row_vector(int i) const {
+        const T* from = values.data() + offset(i);
+        return std::vector<double>(from, from + num_cols);
+    }
+
+    /**
+     * @brief Copy a single row into an existing vector, reusing its storage.
+     */
+    template <typename U>
+    void copy_row_to(int i, std::vector<U>& out) const {
+        const T* from = values.data() + offset(i);
+        out.assign(from, from + num_cols);
+    }
+
+    /**
+     * @brief Copy the population out as nested vectors (one per individual).
+     */
+    std::vector<std::vector<double>> to_vectors() const {
+        std::vector<std::vector<double>> out;
+        out.reserve(num_rows);
+        for (int i = 0; i < num_rows; ++i) {
+            out.push_back(row_vector(i));
+        }
+        return out;
+    }
+
+private:
+    int num_rows = 0;
+    int num_cols = 0;
+    std::vector<T, AlignedAllocator<T>> values;
+
+    std::size_t offset(int i) const { return static_cast<std::size_t>(i) * num_cols; }
+};
+
+using Population = BasicPopulation<double>;
+using Population32 = BasicPopulation<float>;
+
+/**
+ * @brief Of a double/float pair of members, the one holding T.
+ *
+ * Lets code templated on the storage type reach the matching buffer, e.g.
+ * by_precision<T>(positions, positions32).
+ */
+template <typename T, typename Wide, typename Narrow>
+auto& by_precision(Wide& wide, Narrow& narrow) {
+    if constexpr (std::is_same<T, double>::value) {
+        return wide;
+    } else {
+        return narrow;
+    }
+}
+
+#endif // POPULATION_H
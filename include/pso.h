@@ -2,9 +2,12 @@
 #define PSO_H
 
 #include "base_optimizer.h"
+#include "kernels.h"
+#include "policies.h"
+#include "topology.h"
+#include <deque>
 #include <vector>
 #include <functional>
-#include <random>
 
 /**
  * @brief Particle Swarm Optimization (PSO) optimizer.
@@ -27,7 +30,8 @@ public:
      * @param verbose Enable verbose output.
      * @param seed Random seed.
      * @param velocity_init_random If true, initialize velocities randomly.
-     * @param use_ring_topology If true, use ring topology for local best.
+     * @param use_ring_topology If true, use ring topology for local best
+     *        (shorthand for set_topology(TopologyKind::Ring, neighbor_size)).
      * @param neighbor_size Neighborhood size for ring topology.
      * @param use_w_decrement If true, linearly decrease inertia weight.
      * @param w_start Starting inertia weight (if decrement is used).
@@ -51,57 +55,110 @@ public:
     virtual ~PSO() {}
 
     // Base class overrides with snake_case names.
-    void set_objective(std::function<double(const std::vector<double>&)> obj) override;
-    void optimize(int iterations) override;
-    std::vector<double> get_best_solution() const override;
+    const std::vector<double>& get_best_solution() const override;
     double get_best_fitness() const override;
+    const Population& get_population() const override;
+    const Population32* get_population32() const override;
+    const std::vector<double>& get_fitness() const override;
 
     /**
-     * @brief Retrieve the population history.
+     * @brief Choose where each particle takes its social best from.
      *
-     * @return std::vector<std::vector<std::vector<double>>> Population history.
+     * Neighborhood bests are maintained incrementally as personal bests
+     * improve, so wide neighborhoods cost nothing extra per iteration.
+     * get_best_fitness() stays the best personal best of the whole swarm.
+     *
+     * @param kind Topology kind.
+     * @param neighbor_size Ring half-width (Ring, RandomRegular) or number of
+     *        particles each particle informs (Dynamic); unused otherwise.
+     *        At most max_neighbor_size(kind, num_individuals).
      */
-    std::vector<std::vector<std::vector<double>>> get_population_history() const;
+    void set_topology(TopologyKind kind, int neighbor_size = 1);
 
-private:
-    std::function<double(const std::vector<double>&)> objective_function;
+    TopologyKind get_topology() const { return topology_kind; }
+    int get_neighbor_size() const { return neighbor_size; }
+
+protected:
+    // Stepping hooks driven by BaseOptimizer.
+    std::vector<double>& fitness_buffer() override;
+    void absorb_initial() override;
+    void generate() override;
+    void absorb() override;
+    void replace_individual(int i, const double* genome, double fitness) override;
+    const char* algorithm_name() const override { return "PSO"; }
+    void save_state(CheckpointWriter& out) const override;
+    void load_state(CheckpointReader& in) override;
+    bool supports_async() const override { return true; }
+    bool supports_float32() const override { return true; }
+    void precision_changed() override;
+    void begin_async() override;
+    int propose_async(double* candidate) override;
+    void accept_async(int slot, const double* candidate, double fitness) override;
 
+private:
     // Core configuration parameters.
-    int max_iter;
     double c1, c2, w, v_max;
-    bool minimize;
-    bool verbose;
 
     // Optional toggles.
     bool velocity_init_random;
-    bool use_ring_topology;
+    TopologyKind topology_kind;
     int neighbor_size;
     bool use_w_decrement;
     double w_start, w_end;
-    bool store_history_each_iter;
-
-    std::mt19937 rng;
 
     // Particle data.
-    std::vector<std::vector<double>> positions;
-    std::vector<std::vector<double>> velocities;
-    std::vector<std::vector<double>> pbest_positions;
+    Population positions;
+    Population velocities;
+    Population pbest_positions;
     std::vector<double> pbest_fitness;
+    std::vector<double> fitness;
 
     // Global best solution.
     std::vector<double> gbest_position;
     double gbest_fitness;
 
-    // Population history.
-    std::vector<std::vector<std::vector<double>>> population_history;
+    // Float32 mode keeps the particle data here instead and releases the
+    // double arrays above; gbest_position stays double, with a rounded copy
+    // for the kernels.
+    Population32 positions32;
+    Population32 velocities32;
+    Population32 pbest_positions32;
+    std::vector<float> gbest_position32;
+
+    // Neighborhood graph and bests; Dynamic redraws it under a new epoch.
+    Topology topology;
+    uint64_t topology_epoch = 0;
+
+    // Specializations for the current precision, direction, topology, v_max
+    // and dim, picked by select_kernels().
+    PSOKernel update_kernel = nullptr;
+    PSOKernel32 update_kernel32 = nullptr;
+    void (PSO::*update_positions_fn)() = nullptr;
+    void (PSO::*absorb_fn)() = nullptr;
+
+    // Asynchronous mode: particles with no evaluation in flight, and scratch.
+    std::deque<int> idle_particles;
+    std::vector<double> async_r1, async_r2;
+    std::vector<float> async_r1_32, async_r2_32;
 
     // Helper methods.
     void initialize_particles();
     void update_positions(int iteration);
-    int get_local_best_index(int i);
+    template <typename T>
+    void update_particle(const PSOUpdateParams& params, int i, RandomStream& stream, T* r1, T* r2);
+    bool improve_personal_best(int i, double fit);
+    void rebuild_topology();
+    void check_neighbor_size(TopologyKind kind, int size) const;
+    void select_kernels();
+
+    // Policy-specialized bodies of the helpers above; T is the storage type.
+    template <typename T, bool Global> void update_positions_with();
+    template <typename T, bool Global>
+    void update_particle_with(const PSOUpdateParams& params, int i, RandomStream& stream, T* r1, T* r2);
+    template <typename T> void absorb_initial_with();
+    template <typename T, typename Direction> void absorb_with();
+    template <typename T, typename Direction> bool improve_with(int i, double fit);
     void update_inertia(int iteration, int total_iters);
-    void clamp_velocity(std::vector<double>& velocity);
-    void enforce_bounds(std::vector<double>& individual);
 };
 
 #endif // PSO_H
@@ -0,0 +1,198 @@
+#ifndef RANDOM_STREAM_H
+#define RANDOM_STREAM_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @brief Philox4x32-10 counter-based random number generator.
+ *
+ * Maps a 128-bit counter and a 64-bit key to 128 random bits with no hidden
+ * state, so any block of any stream can be produced independently.
+ */
+struct Philox4x32 {
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static Counter generate(Counter ctr, Key key) {
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * ctr[0];
+            uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * ctr[2];
+            ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+                   static_cast<uint32_t>(p1),
+                   static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+                   static_cast<uint32_t>(p0)};
+        }
+        return ctr;
+    }
+};
+
+/**
+ * @brief Independent random stream keyed by (seed, step, individual, lane).
+ *
+ * Every individual gets its own stream per optimizer step, so the numbers an
+ * individual sees do not depend on how work is split across threads or on
+ * the order rows are processed. Lanes separate different uses of the same
+ * (step, individual) pair, e.g. selection and breeding in the GA.
+ */
+class RandomStream {
+public:
+    /**
+     * @brief Construct a new Random Stream object.
+     *
+     * @param seed Optimizer seed.
+     * @param step Optimizer step (0 is used for initialization).
+     * @param individual Index of the individual the stream belongs to.
+     * @param lane Sub-stream for a distinct use (0-255).
+     */
+    RandomStream(uint64_t seed, uint64_t step, uint64_t individual, uint32_t lane = 0)
+        : key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          counter{0u,
+                  static_cast<uint32_t>(individual),
+                  static_cast<uint32_t>(step),
+                  (static_cast<uint32_t>(step >> 32) & 0x00FFFFFFu) | (lane << 24)} {}
+
+    /**
+     * @brief Next 32 random bits.
+     */
+    uint32_t next_u32() {
+        if (index == 4) {
+            refill();
+        }
+        return block[index++];
+    }
+
+    /**
+     * @brief Uniform double in [0, 1) with 53 random bits.
+     */
+    double uniform() {
+        uint32_t hi = next_u32();
+        uint32_t lo = next_u32();
+        return to_unit(hi, lo);
+    }
+
+    /**
+     * @brief Uniform double in [lo, hi).
+     */
+    double uniform(double lo, double hi) {
+        return lo + (hi - lo) * uniform();
+    }
+
+    /**
+     * @brief Uniform integer in [lo, hi] (inclusive), without modulo bias.
+     */
+    int uniform_int(int lo, int hi) {
+        uint32_t range = static_cast<uint32_t>(hi - lo) + 1u;
+        if (range == 0) {
+            return static_cast<int>(next_u32());
+        }
+        uint64_t m = static_cast<uint64_t>(next_u32()) * range;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < range) {
+            uint32_t threshold = (0u - range) % range;
+            while (low < threshold) {
+                m = static_cast<uint64_t>(next_u32()) * range;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return lo + static_cast<int>(m >> 32);
+    }
+
+    /**
+     * @brief Standard normal deviate (Box-Muller, second value cached).
+     */
+    double normal() {
+        if (has_spare) {
+            has_spare = false;
+            return spare;
+        }
+        double u1 = 1.0 - uniform();  // (0, 1], keeps log() finite
+        double u2 = uniform();
+        double radius = std::sqrt(-2.0 * std::log(u1));
+        double angle = 6.283185307179586 * u2;
+        spare = radius * std::sin(angle);
+        has_spare = true;
+        return radius * std::cos(angle);
+    }
+
+    /**
+     * @brief Fill `out` with n uniforms in [0, 1).
+     *
+     * Equivalent to n calls to uniform(), but whole Philox blocks are
+     * converted in a tight loop when the stream is at a block boundary.
+     */
+    void fill_uniform(double* out, int n) {
+        int k = 0;
+        if (index == 4) {
+            for (; k + 2 <= n; k += 2) {
+                Philox4x32::Counter r = Philox4x32::generate(counter, key);
+                ++counter[0];
+                out[k] = to_unit(r[0], r[1]);
+                out[k + 1] = to_unit(r[2], r[3]);
+            }
+        }
+        for (; k < n; ++k) {
+            out[k] = uniform();
+        }
+    }
+
+    /**
+     * @brief Fill `out` with n single-precision uniforms in [0, 1).
+     *
+     * Each value takes 24 random bits, one 32-bit word, so a Philox block
+     * yields four of them.
+     */
+    void fill_uniform(float* out, int n) {
+        int k = 0;
+        if (index == 4) {
+            for (; k + 4 <= n; k += 4) {
+                Philox4x32::Counter r = Philox4x32::generate(counter, key);
+                ++counter[0];
+                for (int j = 0; j < 4; ++j) {
+                    out[k + j] = to_unit_float(r[j]);
+                }
+            }
+        }
+        for (; k < n; ++k) {
+            out[k] = to_unit_float(next_u32());
+        }
+    }
+
+    /**
+     * @brief Fill `out` with n standard normal deviates.
+     */
+    void fill_normal(double* out, int n) {
+        for (int k = 0; k < n; ++k) {
+            out[k] = normal();
+        }
+    }
+
+private:
+    Philox4x32::Key key;
+    Philox4x32::Counter counter;
+    Philox4x32::Counter block{};
+    int index = 4;
+    double spare = 0.0;
+    bool has_spare = false;
+
+    void refill() {
+        block = Philox4x32::generate(counter, key);
+        ++counter[0];
+        index = 0;
+    }
+
+    static double to_unit(uint32_t hi, uint32_t lo) {
+        return static_cast<double>(((static_cast<uint64_t>(hi) << 32) | lo) >> 11) * 0x1.0p-53;
+    }
+
+    static float to_unit_float(uint32_t bits) {
+        return static_cast<float>(bits >> 8) * 0x1.0p-24f;
+    }
+};
+
+#endif // RANDOM_STREAM_H
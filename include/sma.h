@@ -2,9 +2,10 @@
 #define SMA_H
 
 #include "base_optimizer.h"
+#include "kernels.h"
+#include "policies.h"
 #include <vector>
 #include <functional>
-#include <random>
 
 /**
  * @brief Slime Mold Algorithm (SMA) optimizer.
@@ -51,57 +52,70 @@ public:
     virtual ~SMA() {}
 
     // Base class overrides with snake_case names.
-    void set_objective(std::function<double(const std::vector<double>&)> obj) override;
-    void optimize(int iterations) override;
-    std::vector<double> get_best_solution() const override;
+    const std::vector<double>& get_best_solution() const override;
     double get_best_fitness() const override;
-
-    /**
-     * @brief Retrieve the population history.
-     *
-     * @return std::vector<std::vector<std::vector<double>>> Population history.
-     */
-    std::vector<std::vector<std::vector<double>>> get_population_history() const;
+    const Population& get_population() const override;
+    const Population32* get_population32() const override;
+    const std::vector<double>& get_fitness() const override;
 
     /**
      * @brief Update positions for debugging/stepping purposes.
      *
+     * get_population() reflects the move at once; get_fitness() still
+     * describes the previous positions until they are evaluated.
+     *
      * @param iteration Current iteration.
      */
     void update_positions(int iteration);
 
+protected:
+    // Stepping hooks driven by BaseOptimizer.
+    std::vector<double>& fitness_buffer() override;
+    void absorb_initial() override;
+    void generate() override;
+    void absorb() override;
+    void replace_individual(int i, const double* genome, double fitness) override;
+    const char* algorithm_name() const override { return "SMA"; }
+    void save_state(CheckpointWriter& out) const override;
+    void load_state(CheckpointReader& in) override;
+    bool supports_float32() const override { return true; }
+    void precision_changed() override;
+
 private:
-    std::function<double(const std::vector<double>&)> objective_function;
-    int max_iter;
     double c1, c2;
     double w;  // Current inertia scaling factor.
-    bool minimize;
-    bool verbose;
 
     // Toggles and parameters.
     bool random_init_positions;
     bool use_w_decrement;
     double w_start;
     double w_end;
-    bool store_history_each_iter;
-
-    std::mt19937 rng;
 
     // Particle positions and fitness values.
-    std::vector<std::vector<double>> positions;
+    Population positions;
     std::vector<double> fitness;
 
     // Global best position and fitness.
     std::vector<double> best_position;
     double best_fitness;
 
-    // Population history.
-    std::vector<std::vector<std::vector<double>>> population_history;
+    // Float32 mode keeps the positions here instead and releases the double
+    // ones; best_position stays double, with a rounded copy for the kernel.
+    Population32 positions32;
+    std::vector<float> best_position32;
+
+    // Specializations for the current precision, direction and dim, picked
+    // by select_kernels().
+    SMAKernel update_kernel = nullptr;
+    SMAKernel32 update_kernel32 = nullptr;
+    void (SMA::*absorb_fn)() = nullptr;
 
     // Helper methods.
     void initialize_positions();
-    void enforce_bounds(std::vector<double>& individual);
     void update_inertia(int iteration, int total_iters);
+    void select_kernels();
+    template <typename T> void update_positions_with();
+    template <typename T, typename Direction> void absorb_with();
 };
 
 #endif // SMA_H
@@ -0,0 +1,106 @@
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include "checkpoint.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Settings of surrogate pre-screening; see BaseOptimizer::set_surrogate().
+ */
+struct SurrogateSettings {
+    int capacity = 0;               // Archive size (0 disables the surrogate).
+    int neighbors = 8;              // k of the k-nearest-neighbour regression.
+    double evaluate_fraction = 0.25; // Share of candidates, best predicted first, sent to the objective.
+    double explore_fraction = 0.05;  // Further share drawn at random from the rest.
+    int min_points = 32;            // Archive size at which screening starts (at least `neighbors`).
+};
+
+/**
+ * @brief k-nearest-neighbour regression over an archive of evaluated genomes.
+ *
+ * Predicts fitness as the inverse-squared-distance weighted mean of the
+ * `neighbors` nearest archived genomes. Once the archive holds at least
+ * 2^dim genomes it is indexed by a k-d tree; new genomes go into an
+ * unindexed tail that queries scan linearly and that is folded into the
+ * tree once it outgrows a quarter of it, so an insert costs O(dim) plus an
+ * amortized O(log n) share of a rebuild. Smaller archives are scanned in
+ * full, with distances abandoned early. When full, the oldest quarter of
+ * the archive is dropped. Neighbours are
+ * ordered by (distance, age), so predictions do not depend on the index
+ * layout. predict() is safe to call from several threads; insert() is not.
+ */
+class Surrogate {
+public:
+    /**
+     * @brief Drop the archive and counters and apply new settings.
+     *
+     * @param settings Settings; capacity 0 disables the surrogate.
+     * @param dim Values per genome.
+     */
+    void configure(const SurrogateSettings& settings, int dim);
+
+    bool enabled() const { return settings.capacity > 0; }
+    const SurrogateSettings& get_settings() const { return settings; }
+    int size() const { return static_cast<int>(values.size()); }
+
+    /**
+     * @brief Whether the archive is large enough to screen candidates.
+     */
+    bool ready() const;
+
+    /**
+     * @brief Predicted fitness of a genome of `dim` values.
+     */
+    double predict(const double* genome) const;
+
+    /**
+     * @brief Add an evaluated genome to the archive.
+     */
+    void insert(const double* genome, double fitness);
+
+    /**
+     * @brief Count candidates whose fitness was predicted instead of evaluated.
+     */
+    void count_screened(int count) { screened += static_cast<uint64_t>(count); }
+
+    // Objective evaluations saved so far.
+    uint64_t get_screened() const { return screened; }
+
+    /**
+     * @brief Write the settings, archive and counter to a checkpoint.
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * @brief Restore what save() wrote, for genomes of `dim` values.
+     */
+    void load(CheckpointReader& in, int dim);
+
+private:
+    SurrogateSettings settings;
+    int dim = 0;
+    uint64_t screened = 0;
+
+    // Archive, oldest first: genomes (row-major) and their fitness.
+    std::vector<double> genomes;
+    std::vector<double> values;
+
+    // Implicit k-d tree over the first `indexed` genomes: a subtree on
+    // tree_order[lo, hi) of more than LEAF_SIZE genomes splits at
+    // mid = (lo + hi) / 2 into [lo, mid) and [mid, hi), at split_value[mid]
+    // along split_dim[mid]; smaller ones are leaves scanned in full.
+    static const int LEAF_SIZE = 8;
+    int indexed = 0;
+    std::vector<int> tree_order;
+    std::vector<int> split_dim;
+    std::vector<double> split_value;
+
+    struct Query;
+    void search(int lo, int hi, double bound, Query& query) const;
+    void rebuild();
+    void build(int lo, int hi);
+    const double* genome(int i) const { return genomes.data() + static_cast<std::size_t>(i) * dim; }
+};
+
+#endif // SURROGATE_H
@@ -0,0 +1,50 @@
+#ifndef TERMINATION_H
+#define TERMINATION_H
+
+#include "population.h"
+#include <cstdint>
+
+/**
+ * @brief Why the last optimize() call returned.
+ */
+enum class StopReason {
+    NotStopped,        // Still running, or never run.
+    MaxIterations,     // Ran the requested number of iterations.
+    MaxEvaluations,    // Objective evaluation budget used up.
+    Deadline,          // Wall-clock budget used up.
+    TargetReached,     // Best fitness reached the target.
+    Stagnation,        // Best fitness stopped improving.
+    DiversityCollapse, // Population converged to (nearly) one point.
+    Callback           // The progress callback asked to stop.
+};
+
+/**
+ * @brief Stopping rules checked after every iteration, on top of the
+ * iteration count passed to optimize(). A zero value disables a rule.
+ */
+struct TerminationCriteria {
+    uint64_t max_evaluations = 0;    // Total objective evaluations.
+    double max_seconds = 0.0;        // Wall-clock seconds per optimize() call.
+    bool has_target = false;         // Stop once the best fitness reaches target_fitness.
+    double target_fitness = 0.0;
+    int stagnation_window = 0;       // Stop after this many iterations without
+    double stagnation_epsilon = 0.0; // an improvement larger than epsilon.
+    double min_diversity = 0.0;      // Stop when population_diversity() falls below this.
+};
+
+/**
+ * @brief Human-readable name of a stop reason.
+ */
+const char* stop_reason_name(StopReason reason);
+
+/**
+ * @brief Spread of a population: the standard deviation of each coordinate,
+ * averaged over dimensions and divided by the search range.
+ *
+ * Zero when all individuals coincide; roughly 0.29 for a uniform random
+ * population.
+ */
+double population_diversity(const Population& population, double lower_bound, double upper_bound);
+double population_diversity(const Population32& population, double lower_bound, double upper_bound);
+
+#endif // TERMINATION_H
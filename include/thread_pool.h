@@ -0,0 +1,71 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Persistent pool of worker threads for data-parallel loops.
+ *
+ * Workers are started once and sleep between jobs, so an optimizer can reuse
+ * the same pool every generation. The calling thread takes part in each loop.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Construct a new Thread Pool object.
+     *
+     * @param num_threads Total number of threads including the caller (0 = hardware concurrency).
+     */
+    explicit ThreadPool(int num_threads);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Number of threads taking part in a loop, including the caller.
+     */
+    int size() const { return static_cast<int>(workers.size()) + 1; }
+
+    /**
+     * @brief Run body over [0, count) split into chunks.
+     *
+     * Chunks are claimed from a shared counter by whichever thread is free
+     * next, so uneven per-item cost is balanced automatically. Blocks until
+     * every chunk has finished and rethrows the first exception raised.
+     *
+     * @param count Number of items.
+     * @param chunk_size Items per chunk (0 = pick automatically).
+     * @param body Callable invoked as body(begin, end) for each chunk.
+     */
+    void parallel_for(int count, int chunk_size, const std::function<void(int, int)>& body);
+
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable job_ready;
+    std::condition_variable job_done;
+    bool stopping = false;
+    unsigned long job_id = 0;
+    int active_workers = 0;
+
+    // Current job, valid while active_workers > 0.
+    const std::function<void(int, int)>* job_body = nullptr;
+    int job_count = 0;
+    int job_chunk = 1;
+    std::atomic<int> next_index{0};
+    std::exception_ptr job_error;
+
+    void worker_loop();
+    void run_chunks();
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,87 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Which particles each PSO particle takes its social best from.
+ */
+enum class TopologyKind {
+    Global,        // Every particle sees the whole swarm.
+    Ring,          // neighbor_size particles on each side of the index.
+    VonNeumann,    // Left, right, up and down on a wrapped grid of ceil(sqrt(N)) columns.
+    RandomRegular, // A ring over a random permutation: 2 * neighbor_size random neighbors, fixed.
+    Dynamic        // Each particle informs neighbor_size random others; redrawn after
+                   // every iteration that does not improve the global best.
+};
+
+/**
+ * @brief Human-readable name of a topology.
+ */
+const char* topology_name(TopologyKind kind);
+
+/**
+ * @brief Largest useful neighbor_size for `n` particles: n / 2 already
+ * covers the whole ring and n - 1 informants the whole swarm. Kinds that
+ * ignore neighbor_size have no limit.
+ */
+int max_neighbor_size(TopologyKind kind, int n);
+
+/**
+ * @brief Neighborhood graph of a swarm with incrementally maintained
+ * neighborhood bests.
+ *
+ * Neighborhoods are stored as compact adjacency (CSR) together with the
+ * transpose (which particles each one informs). Personal bests only ever
+ * improve, so when particle i improves only the neighborhoods containing i
+ * need a comparison: improved() costs O(deg(i)) instead of a full O(N * k)
+ * rescan per iteration. Every neighborhood contains its own particle.
+ * Bests are ranked by fitness and then by index, so ties resolve to the
+ * lowest index on both paths.
+ */
+class Topology {
+public:
+    /**
+     * @brief Build the graph for `n` particles.
+     *
+     * @param kind Topology kind; Global stores no graph.
+     * @param n Number of particles.
+     * @param neighbor_size Ring half-width, or informants per particle (Dynamic).
+     * @param seed Seed of the random topologies.
+     * @param epoch Draw number: Dynamic uses a new one for every redraw.
+     */
+    void build(TopologyKind kind, int n, int neighbor_size, uint64_t seed, uint64_t epoch = 0);
+
+    TopologyKind get_kind() const { return kind; }
+    bool is_global() const { return kind == TopologyKind::Global; }
+
+    // Neighbors of particle i (the particles it takes its best from).
+    int degree(int i) const { return offsets[i + 1] - offsets[i]; }
+    const int* neighbors(int i) const { return neighbor_index.data() + offsets[i]; }
+
+    /**
+     * @brief Recompute every neighborhood best from scratch.
+     */
+    void reset_bests(const std::vector<double>& fitness, bool minimize);
+
+    /**
+     * @brief Record that the personal best of particle i improved to fitness[i].
+     */
+    void improved(int i, const std::vector<double>& fitness, bool minimize);
+
+    /**
+     * @brief Index of the best personal best in particle i's neighborhood.
+     */
+    int best(int i) const { return local_best[i]; }
+
+private:
+    TopologyKind kind = TopologyKind::Global;
+    std::vector<int> offsets;          // CSR row starts, n + 1 entries.
+    std::vector<int> neighbor_index;   // Neighbors of each particle.
+    std::vector<int> informed_offsets; // Transpose: particles each one informs.
+    std::vector<int> informed_index;
+    std::vector<int> local_best;
+};
+
+#endif // TOPOLOGY_H
@@ -1,10 +1,14 @@
 #include "../../include/ga.h"
-#include <iostream>
 #include <limits>
-#include <random>
 #include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
+// Random stream lanes, so selection and breeding for the same index never share numbers.
+static const uint32_t SELECTION_LANE = 0;
+static const uint32_t BREEDING_LANE = 1;
+static const uint32_t STEADY_STATE_LANE = 2;
+
 GA::GA(int num_individuals,
        int dim,
        double lower_bound,
@@ -21,157 +25,278 @@ GA::GA(int num_individuals,
        bool use_gaussian_mutation,
        double mutation_std,
        bool store_history_each_iter)
-    : BaseOptimizer(num_individuals, dim, lower_bound, upper_bound),
-      max_iter(max_iter),
-      minimize(minimize),
-      verbose(verbose),
+    : BaseOptimizer(num_individuals, dim, lower_bound, upper_bound,
+                    max_iter, minimize, verbose, store_history_each_iter),
       crossover_rate(crossover_rate),
       mutation_rate(mutation_rate),
       tournament_size(tournament_size),
       elitism_count(elitism_count),
       use_uniform_crossover(use_uniform_crossover),
       use_gaussian_mutation(use_gaussian_mutation),
-      mutation_std(mutation_std),
-      store_history_each_iter(store_history_each_iter),
-      rng(seed)
+      mutation_std(mutation_std)
 {
+    rng_seed = static_cast<uint64_t>(seed);
     if (this->mutation_std <= 0.0) {
         this->mutation_std = (upper_bound - lower_bound) * 0.1;
     }
     best_solution.resize(dim);
     best_fitness = (minimize ? std::numeric_limits<double>::max() : std::numeric_limits<double>::lowest());
     initialize_population();
+    select_kernels();
 }
 
-void GA::set_objective(std::function<double(const std::vector<double>&)> obj) {
-    objective_function = obj;
+void GA::select_kernels() {
+    // Indexed by [maximize][uniform crossover][gaussian mutation].
+    static void (GA::*const generators[2][2][2])() = {
+        {{&GA::generate_with<Minimize, false, false>, &GA::generate_with<Minimize, false, true>},
+         {&GA::generate_with<Minimize, true, false>, &GA::generate_with<Minimize, true, true>}},
+        {{&GA::generate_with<Maximize, false, false>, &GA::generate_with<Maximize, false, true>},
+         {&GA::generate_with<Maximize, true, false>, &GA::generate_with<Maximize, true, true>}},
+    };
+    generate_fn = generators[minimize ? 0 : 1][use_uniform_crossover][use_gaussian_mutation];
+    update_best_fn = minimize ? &GA::update_best_with<Minimize> : &GA::update_best_with<Maximize>;
 }
 
 void GA::initialize_population() {
-    std::uniform_real_distribution<double> dist(lower_bound, upper_bound);
-    population.resize(num_individuals, std::vector<double>(dim));
+    population.resize(num_individuals, dim);
+    new_population.resize(num_individuals, dim);
+    mating_pool.resize(num_individuals);
+    ranking.resize(num_individuals);
+    source.resize(num_individuals);
+    carried_fitness.resize(num_individuals);
+    // Every row of the initial population needs evaluating.
+    changed_rows.resize(num_individuals);
+    for (int i = 0; i < num_individuals; ++i) {
+        changed_rows[i] = i;
+    }
     fitness.resize(num_individuals);
     for (int i = 0; i < num_individuals; ++i) {
-        for (int d = 0; d < dim; ++d) {
-            population[i][d] = dist(rng);
+        RandomStream stream(rng_seed, 0, i);
+        for (double& x : population.row(i)) {
+            x = stream.uniform(lower_bound, upper_bound);
         }
     }
 }
 
-void GA::evaluate_population() {
+void GA::update_best() {
+    (this->*update_best_fn)();
+}
+
+template <typename Direction>
+void GA::update_best_with() {
     for (int i = 0; i < num_individuals; ++i) {
-        double f = objective_function(population[i]);
-        fitness[i] = f;
-        if ((minimize && f < best_fitness) || (!minimize && f > best_fitness)) {
+        double f = fitness[i];
+        if (Direction::better(f, best_fitness)) {
             best_fitness = f;
-            best_solution = population[i];
+            population.copy_row_to(i, best_solution);
         }
     }
 }
 
-std::vector<std::vector<double>> GA::selection() {
-    std::uniform_int_distribution<int> dist_idx(0, num_individuals - 1);
-    std::vector<std::vector<double>> mating_pool;
-    mating_pool.reserve(num_individuals);
-    for (int i = 0; i < num_individuals; ++i) {
-        int best_idx = dist_idx(rng);
-        for (int j = 1; j < tournament_size; ++j) {
-            int idx = dist_idx(rng);
-            if ((minimize && fitness[idx] < fitness[best_idx]) ||
-                (!minimize && fitness[idx] > fitness[best_idx])) {
-                best_idx = idx;
-            }
+template <typename Direction>
+void GA::selection_with() {
+    parallel_rows(num_individuals, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            RandomStream stream(rng_seed, rng_step, i, SELECTION_LANE);
+            mating_pool[i] = tournament_with<Direction>(stream);
+        }
+    });
+}
+
+int GA::tournament(RandomStream& stream) const {
+    return minimize ? tournament_with<Minimize>(stream) : tournament_with<Maximize>(stream);
+}
+
+template <typename Direction>
+int GA::tournament_with(RandomStream& stream) const {
+    int best_idx = stream.uniform_int(0, num_individuals - 1);
+    for (int j = 1; j < tournament_size; ++j) {
+        int idx = stream.uniform_int(0, num_individuals - 1);
+        if (Direction::better(fitness[idx], fitness[best_idx])) {
+            best_idx = idx;
         }
-        mating_pool.push_back(population[best_idx]);
     }
-    return mating_pool;
+    return best_idx;
 }
 
-std::vector<double> GA::crossover(const std::vector<double>& parent1, const std::vector<double>& parent2) {
-    std::vector<double> offspring(dim);
-    std::uniform_real_distribution<double> dist01(0.0, 1.0);
+void GA::crossover(const double* parent1, const double* parent2, double* offspring, RandomStream& stream) {
     if (use_uniform_crossover) {
+        crossover_with<true>(parent1, parent2, offspring, stream);
+    } else {
+        crossover_with<false>(parent1, parent2, offspring, stream);
+    }
+}
+
+template <bool Uniform>
+void GA::crossover_with(const double* parent1, const double* parent2, double* offspring, RandomStream& stream) {
+    if (Uniform) {
         for (int d = 0; d < dim; ++d) {
-            offspring[d] = (dist01(rng) < crossover_rate) ? parent1[d] : parent2[d];
+            offspring[d] = (stream.uniform() < crossover_rate) ? parent1[d] : parent2[d];
         }
     } else {
-        std::uniform_int_distribution<int> dist_point(1, dim - 1);
-        int cp = dist_point(rng);
+        int cp = (dim > 1) ? stream.uniform_int(1, dim - 1) : dim;
         for (int d = 0; d < dim; ++d) {
             offspring[d] = (d < cp) ? parent1[d] : parent2[d];
         }
     }
-    return offspring;
 }
 
-void GA::mutate(std::vector<double>& individual) {
-    std::uniform_real_distribution<double> dist01(0.0, 1.0);
-    std::uniform_real_distribution<double> dist_range(lower_bound, upper_bound);
+bool GA::mutate(double* individual, RandomStream& stream) {
+    return use_gaussian_mutation ? mutate_with<true>(individual, stream) : mutate_with<false>(individual, stream);
+}
+
+template <bool Gaussian>
+bool GA::mutate_with(double* individual, RandomStream& stream) {
+    bool mutated = false;
     for (int d = 0; d < dim; ++d) {
-        if (dist01(rng) < mutation_rate) {
-            if (use_gaussian_mutation) {
-                std::normal_distribution<double> gauss(0.0, mutation_std);
-                individual[d] += gauss(rng);
+        if (stream.uniform() < mutation_rate) {
+            mutated = true;
+            if (Gaussian) {
+                individual[d] += mutation_std * stream.normal();
             } else {
-                individual[d] = dist_range(rng);
+                individual[d] = stream.uniform(lower_bound, upper_bound);
             }
         }
     }
+    return mutated;
 }
 
-void GA::enforce_bounds(std::vector<double>& individual) {
+void GA::enforce_bounds(double* individual) {
     for (int d = 0; d < dim; ++d) {
         if (individual[d] < lower_bound) individual[d] = lower_bound;
         if (individual[d] > upper_bound) individual[d] = upper_bound;
     }
 }
 
-void GA::optimize(int iterations) {
-    if (!objective_function) {
-        throw std::runtime_error("Objective function not set!");
+void GA::settle_population() {
+    if (buffers_swapped) {
+        new_population = population;
+        population.swap(new_population);
+        buffers_swapped = false;
     }
-    int iter_limit = (iterations == -1) ? max_iter : iterations;
-    evaluate_population();
-    if (store_history_each_iter) {
-        population_history.push_back(population);
+}
+
+void GA::evaluate_candidates() {
+    if (static_cast<int>(changed_rows.size()) == num_individuals) {
+        evaluate(population, fitness);
+    } else {
+        evaluate(population, fitness, changed_rows);
     }
-    for (int iter = 0; iter < iter_limit; ++iter) {
-        std::vector<std::vector<double>> mating_pool = selection();
-        std::vector<std::vector<double>> new_population;
-        std::vector<int> indices(num_individuals);
+}
+
+void GA::absorb_initial() {
+    update_best();
+}
+
+void GA::absorb() {
+    update_best();
+}
+
+void GA::generate() {
+    (this->*generate_fn)();
+}
+
+template <typename Direction, bool Uniform, bool Gaussian>
+void GA::generate_with() {
+    ++rng_step;
+    int elites = std::min(std::max(elitism_count, 0), num_individuals);
+    {
+        Instrumentation::Scope scope(instrumentation, Phase::Selection);
+        selection_with<Direction>();
+        // Only the elites need to be ranked; ties go to the lower index.
         for (int i = 0; i < num_individuals; ++i) {
-            indices[i] = i;
+            ranking[i] = i;
         }
-        std::sort(indices.begin(), indices.end(), [&](int a, int b) {
-            return (minimize ? (fitness[a] < fitness[b]) : (fitness[a] > fitness[b]));
+        std::partial_sort(ranking.begin(), ranking.begin() + elites, ranking.end(), [&](int a, int b) {
+            if (fitness[a] != fitness[b]) {
+                return Direction::better(fitness[a], fitness[b]);
+            }
+            return a < b;
         });
-        for (int i = 0; i < elitism_count; ++i) {
-            new_population.push_back(population[indices[i]]);
-        }
-        while (new_population.size() < static_cast<size_t>(num_individuals)) {
-            int idx1 = std::uniform_int_distribution<int>(0, mating_pool.size() - 1)(rng);
-            int idx2 = std::uniform_int_distribution<int>(0, mating_pool.size() - 1)(rng);
-            std::vector<double> child = crossover(mating_pool[idx1], mating_pool[idx2]);
-            mutate(child);
-            enforce_bounds(child);
-            new_population.push_back(child);
+    }
+    for (int i = 0; i < elites; ++i) {
+        new_population.copy_row(i, population, ranking[i]);
+        source[i] = ranking[i];
+    }
+    // Children are bred straight into their rows of the back buffer. Each
+    // child draws from its own stream, so breeding is order-independent.
+    parallel_rows(num_individuals - elites, [&](int begin, int end) {
+        for (int c = elites + begin; c < elites + end; ++c) {
+            RandomStream stream(rng_seed, rng_step, c, BREEDING_LANE);
+            int idx1 = stream.uniform_int(0, num_individuals - 1);
+            int idx2 = stream.uniform_int(0, num_individuals - 1);
+            const double* parent1 = population.row(mating_pool[idx1]).data();
+            const double* parent2 = population.row(mating_pool[idx2]).data();
+            double* child = new_population.row(c).data();
+            crossover_with<Uniform>(parent1, parent2, child, stream);
+            source[c] = -1;
+            if (!mutate_with<Gaussian>(child, stream)) {
+                // Parents are within bounds, so an unmutated child that
+                // equals a parent is that parent's clone.
+                if (std::memcmp(child, parent1, dim * sizeof(double)) == 0) {
+                    source[c] = mating_pool[idx1];
+                } else if (std::memcmp(child, parent2, dim * sizeof(double)) == 0) {
+                    source[c] = mating_pool[idx2];
+                }
+            }
         }
-        population = new_population;
-        evaluate_population();
-        if (verbose) {
-            std::cout << "Iteration " << (iter + 1)
-                      << ", Best Fitness: " << best_fitness << std::endl;
+    });
+    {
+        // Only new genomes can be out of bounds; crossover alone keeps them in.
+        Instrumentation::Scope scope(instrumentation, Phase::Bounds);
+        parallel_rows(num_individuals - elites, [&](int begin, int end) {
+            for (int c = elites + begin; c < elites + end; ++c) {
+                if (source[c] < 0) {
+                    enforce_bounds(new_population.row(c).data());
+                }
+            }
+        });
+    }
+    // Clones and elites keep their parent's fitness; only new genomes are evaluated.
+    changed_rows.clear();
+    for (int i = 0; i < num_individuals; ++i) {
+        if (source[i] >= 0) {
+            carried_fitness[i] = fitness[source[i]];
+        } else {
+            changed_rows.push_back(i);
         }
-        if (store_history_each_iter) {
-            population_history.push_back(population);
+    }
+    for (int i = 0; i < num_individuals; ++i) {
+        if (source[i] >= 0) {
+            fitness[i] = carried_fitness[i];
         }
     }
-    if (!store_history_each_iter) {
-        population_history.push_back(population);
+    population.swap(new_population);
+    buffers_swapped = !buffers_swapped;
+}
+
+int GA::propose_async(double* candidate) {
+    // Steady state: breed one child from the current population.
+    RandomStream stream(rng_seed, async_step++, 0, STEADY_STATE_LANE);
+    int parent1 = tournament(stream);
+    int parent2 = tournament(stream);
+    crossover(population.row(parent1).data(), population.row(parent2).data(), candidate, stream);
+    if (mutate(candidate, stream)) {
+        enforce_bounds(candidate);
+    }
+    return 0;
+}
+
+void GA::accept_async(int /*slot*/, const double* candidate, double fit) {
+    // The child replaces the worst individual if it beats it.
+    replace_worst(candidate, fit);
+}
+
+void GA::replace_individual(int i, const double* genome, double fit) {
+    std::copy(genome, genome + dim, population.row(i).data());
+    fitness[i] = fit;
+    if ((minimize && fit < best_fitness) || (!minimize && fit > best_fitness)) {
+        best_fitness = fit;
+        population.copy_row_to(i, best_solution);
     }
 }
 
-std::vector<double> GA::get_best_solution() const {
+const std::vector<double>& GA::get_best_solution() const {
     return best_solution;
 }
 
@@ -179,6 +304,56 @@ double GA::get_best_fitness() const {
     return best_fitness;
 }
 
-std::vector<std::vector<std::vector<double>>> GA::get_population_history() const {
-    return population_history;
+const Population& GA::get_population() const {
+    return population;
+}
+
+const std::vector<double>& GA::get_fitness() const {
+    return fitness;
+}
+
+const std::vector<int>* GA::candidate_rows() const {
+    return static_cast<int>(changed_rows.size()) == num_individuals ? nullptr : &changed_rows;
+}
+
+std::vector<double>& GA::fitness_buffer() {
+    return fitness;
+}
+
+void GA::save_state(CheckpointWriter& out) const {
+    out.write(crossover_rate);
+    out.write(mutation_rate);
+    out.write(static_cast<int32_t>(tournament_size));
+    out.write(static_cast<int32_t>(elitism_count));
+    out.write(static_cast<uint8_t>(use_uniform_crossover));
+    out.write(static_cast<uint8_t>(use_gaussian_mutation));
+    out.write(mutation_std);
+    out.write(best_fitness);
+    out.write_array(population.data(), population.size());
+    out.write_array(fitness);
+    out.write_array(best_solution);
+    // Rows of an asked-for generation that still need evaluating.
+    out.write_array(changed_rows);
+}
+
+void GA::load_state(CheckpointReader& in) {
+    crossover_rate = in.read<double>();
+    mutation_rate = in.read<double>();
+    tournament_size = in.read<int32_t>();
+    elitism_count = in.read<int32_t>();
+    use_uniform_crossover = in.read<uint8_t>() != 0;
+    use_gaussian_mutation = in.read<uint8_t>() != 0;
+    mutation_std = in.read<double>();
+    best_fitness = in.read<double>();
+    in.read_into(population.data(), population.size());
+    in.read_into(fitness);
+    in.read_into(best_solution);
+    std::vector<int> rows = in.read_vector<int>();
+    for (int row : rows) {
+        if (row < 0 || row >= num_individuals) {
+            throw std::runtime_error("Checkpoint is truncated or corrupt.");
+        }
+    }
+    changed_rows = rows;
+    select_kernels();
 }
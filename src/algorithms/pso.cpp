@@ -1,8 +1,13 @@
 #include "../../include/pso.h"
 #include "../../include/base_optimizer.h"
-#include <iostream>
+#include "../../include/kernels.h"
+#include <algorithm>
 #include <limits>
-#include <random>
+#include <stdexcept>
+#include <type_traits>
+
+// Random stream lane for asynchronous updates, kept apart from the generational ones.
+static const uint32_t STEADY_STATE_LANE = 2;
 
 PSO::PSO(int num_individuals,
          int dim,
@@ -20,167 +25,300 @@ PSO::PSO(int num_individuals,
          double w_start,
          double w_end,
          bool store_history_each_iter)
-    : BaseOptimizer(num_individuals, dim, lower_bound, upper_bound),
-      max_iter(max_iter),
+    : BaseOptimizer(num_individuals, dim, lower_bound, upper_bound,
+                    max_iter, minimize, verbose, store_history_each_iter),
       c1(c1),
       c2(c2),
       w(w),
       v_max(v_max),
-      minimize(minimize),
-      verbose(verbose),
       velocity_init_random(velocity_init_random),
-      use_ring_topology(use_ring_topology),
+      topology_kind(use_ring_topology ? TopologyKind::Ring : TopologyKind::Global),
       neighbor_size(neighbor_size),
       use_w_decrement(use_w_decrement),
       w_start(w_start),
-      w_end(w_end),
-      store_history_each_iter(store_history_each_iter),
-      rng(seed)
+      w_end(w_end)
 {
+    check_neighbor_size(topology_kind, neighbor_size);
+    rng_seed = static_cast<uint64_t>(seed);
     initialize_particles();
+    rebuild_topology();
+    select_kernels();
+}
+
+void PSO::set_topology(TopologyKind kind, int size) {
+    check_neighbor_size(kind, size);
+    topology_kind = kind;
+    neighbor_size = size;
+    topology_epoch = 0;
+    rebuild_topology();
+    select_kernels();
+}
+
+void PSO::check_neighbor_size(TopologyKind kind, int size) const {
+    if (size < 0) {
+        throw std::runtime_error("Neighbor size must not be negative.");
+    }
+    if (size > max_neighbor_size(kind, num_individuals)) {
+        throw std::runtime_error("Neighbor size " + std::to_string(size) + " is larger than a " +
+                                 topology_name(kind) + " topology of " + std::to_string(num_individuals) +
+                                 " particles can use.");
+    }
+}
+
+void PSO::precision_changed() {
+    initialize_particles();
+    rebuild_topology();
+    select_kernels();
+}
+
+void PSO::select_kernels() {
+    update_kernel = select_pso_kernel(dim, v_max > 0.0);
+    update_kernel32 = select_pso_kernel32(v_max > 0.0);
+    if (precision == Precision::Float32) {
+        update_positions_fn = topology.is_global() ? &PSO::update_positions_with<float, true>
+                                                   : &PSO::update_positions_with<float, false>;
+        absorb_fn = minimize ? &PSO::absorb_with<float, Minimize> : &PSO::absorb_with<float, Maximize>;
+    } else {
+        update_positions_fn = topology.is_global() ? &PSO::update_positions_with<double, true>
+                                                   : &PSO::update_positions_with<double, false>;
+        absorb_fn = minimize ? &PSO::absorb_with<double, Minimize> : &PSO::absorb_with<double, Maximize>;
+    }
+}
+
+void PSO::rebuild_topology() {
+    topology.build(topology_kind, num_individuals, neighbor_size, rng_seed, topology_epoch);
+    topology.reset_bests(pbest_fitness, minimize);
+}
+
+bool PSO::improve_personal_best(int i, double fit) {
+    if (precision == Precision::Float32) {
+        return minimize ? improve_with<float, Minimize>(i, fit) : improve_with<float, Maximize>(i, fit);
+    }
+    return minimize ? improve_with<double, Minimize>(i, fit) : improve_with<double, Maximize>(i, fit);
+}
+
+template <typename T, typename Direction>
+bool PSO::improve_with(int i, double fit) {
+    if (!Direction::better(fit, pbest_fitness[i])) {
+        return false;
+    }
+    const BasicPopulation<T>& x = by_precision<T>(positions, positions32);
+    pbest_fitness[i] = fit;
+    by_precision<T>(pbest_positions, pbest_positions32).copy_row(i, x, i);
+    topology.improved(i, pbest_fitness, minimize);
+    // gbest is the best personal best under every topology.
+    if (Direction::better(fit, gbest_fitness)) {
+        gbest_fitness = fit;
+        x.copy_row_to(i, gbest_position);
+        if constexpr (std::is_same<T, float>::value) {
+            x.copy_row_to(i, gbest_position32);
+        }
+        return true;
+    }
+    return false;
 }
 
 void PSO::initialize_particles() {
-    positions.resize(num_individuals, std::vector<double>(dim));
-    velocities.resize(num_individuals, std::vector<double>(dim));
-    pbest_positions.resize(num_individuals, std::vector<double>(dim));
+    positions.resize(num_individuals, dim);
+    velocities.resize(num_individuals, dim);
+    pbest_positions.resize(num_individuals, dim);
     pbest_fitness.resize(num_individuals);
+    fitness.resize(num_individuals);
 
     gbest_position.resize(dim);
     gbest_fitness = (minimize ? std::numeric_limits<double>::max() : std::numeric_limits<double>::lowest());
 
-    std::uniform_real_distribution<double> dist_pos(lower_bound, upper_bound);
     double vel_range = (upper_bound - lower_bound) * 0.1;
-    std::uniform_real_distribution<double> dist_vel(-vel_range, vel_range);
 
     for (int i = 0; i < num_individuals; ++i) {
+        RandomStream stream(rng_seed, 0, i);
+        RowSpan<double> x = positions.row(i);
+        RowSpan<double> v = velocities.row(i);
         for (int d = 0; d < dim; ++d) {
-            positions[i][d] = dist_pos(rng);
-            velocities[i][d] = velocity_init_random ? dist_vel(rng) : 0.0;
+            x[d] = stream.uniform(lower_bound, upper_bound);
+            v[d] = velocity_init_random ? stream.uniform(-vel_range, vel_range) : 0.0;
+            // Start inside the velocity limit so the fused update only clamps new values.
+            if (v_max > 0.0) {
+                v[d] = std::min(std::max(v[d], -v_max), v_max);
+            }
         }
     }
-}
 
-void PSO::set_objective(std::function<double(const std::vector<double>&)> obj) {
-    objective_function = obj;
+    // Float32 mode: the same draws, rounded.
+    if (precision == Precision::Float32) {
+        positions32.assign_from(positions);
+        velocities32.assign_from(velocities);
+        pbest_positions32.resize(num_individuals, dim);
+        gbest_position32.assign(dim, 0.0f);
+        positions.release();
+        velocities.release();
+        pbest_positions.release();
+    } else {
+        positions32.release();
+        velocities32.release();
+        pbest_positions32.release();
+        gbest_position32.clear();
+        gbest_position32.shrink_to_fit();
+    }
 }
 
-void PSO::optimize(int iterations) {
-    if (!objective_function) {
-        throw std::runtime_error("Objective function not set!");
+void PSO::absorb_initial() {
+    if (precision == Precision::Float32) {
+        absorb_initial_with<float>();
+    } else {
+        absorb_initial_with<double>();
     }
-    int iter_limit = (iterations == -1) ? max_iter : iterations;
+}
+
+template <typename T>
+void PSO::absorb_initial_with() {
+    const BasicPopulation<T>& x = by_precision<T>(positions, positions32);
+    BasicPopulation<T>& pbest = by_precision<T>(pbest_positions, pbest_positions32);
+    int best = -1;
     for (int i = 0; i < num_individuals; ++i) {
-        double fit = objective_function(positions[i]);
-        pbest_positions[i] = positions[i];
+        double fit = fitness[i];
+        pbest.copy_row(i, x, i);
         pbest_fitness[i] = fit;
         if ((minimize && fit < gbest_fitness) || (!minimize && fit > gbest_fitness)) {
             gbest_fitness = fit;
-            gbest_position = positions[i];
+            best = i;
         }
     }
-    if (store_history_each_iter) {
-        population_history.push_back(positions);
-    }
-    for (int iter = 0; iter < iter_limit; ++iter) {
-        if (use_w_decrement) {
-            update_inertia(iter, iter_limit);
-        }
-        update_positions(iter);
-        for (int i = 0; i < num_individuals; ++i) {
-            double fit = objective_function(positions[i]);
-            if ((minimize && fit < pbest_fitness[i]) || (!minimize && fit > pbest_fitness[i])) {
-                pbest_fitness[i] = fit;
-                pbest_positions[i] = positions[i];
-            }
-            if (!use_ring_topology) {
-                if ((minimize && fit < gbest_fitness) || (!minimize && fit > gbest_fitness)) {
-                    gbest_fitness = fit;
-                    gbest_position = positions[i];
-                }
-            }
-        }
-        if (use_ring_topology) {
-            double ring_best_fit = (minimize ? std::numeric_limits<double>::max() : std::numeric_limits<double>::lowest());
-            std::vector<double> ring_best_pos(dim);
-            for (int i = 0; i < num_individuals; ++i) {
-                if ((minimize && pbest_fitness[i] < ring_best_fit) || (!minimize && pbest_fitness[i] > ring_best_fit)) {
-                    ring_best_fit = pbest_fitness[i];
-                    ring_best_pos = pbest_positions[i];
-                }
-            }
-            gbest_fitness = ring_best_fit;
-            gbest_position = ring_best_pos;
-        }
-        if (verbose) {
-            std::cout << "Iteration " << (iter + 1)
-                      << " Best Fitness: " << gbest_fitness << std::endl;
-        }
-        if (store_history_each_iter) {
-            population_history.push_back(positions);
+    if (best >= 0) {
+        x.copy_row_to(best, gbest_position);
+        if constexpr (std::is_same<T, float>::value) {
+            x.copy_row_to(best, gbest_position32);
         }
     }
-    if (!store_history_each_iter) {
-        population_history.push_back(positions);
+    topology.reset_bests(pbest_fitness, minimize);
+}
+
+void PSO::generate() {
+    if (use_w_decrement) {
+        update_inertia(iteration, horizon);
     }
+    update_positions(iteration);
 }
 
-void PSO::update_positions(int /*iteration*/) {
-    std::uniform_real_distribution<double> dist01(0.0, 1.0);
+void PSO::absorb() {
+    (this->*absorb_fn)();
+}
+
+template <typename T, typename Direction>
+void PSO::absorb_with() {
+    bool gbest_improved = false;
     for (int i = 0; i < num_individuals; ++i) {
-        int best_index = (use_ring_topology ? get_local_best_index(i) : -1);
-        for (int d = 0; d < dim; ++d) {
-            double r1 = dist01(rng);
-            double r2 = dist01(rng);
-            double best_pos_d = use_ring_topology ? pbest_positions[best_index][d] : gbest_position[d];
-            velocities[i][d] = w * velocities[i][d]
-                             + c1 * r1 * (pbest_positions[i][d] - positions[i][d])
-                             + c2 * r2 * (best_pos_d - positions[i][d]);
-            if (v_max > 0.0) {
-                clamp_velocity(velocities[i]);
-            }
-        }
-        for (int d = 0; d < dim; ++d) {
-            positions[i][d] += velocities[i][d];
-        }
-        enforce_bounds(positions[i]);
+        gbest_improved |= improve_with<T, Direction>(i, fitness[i]);
+    }
+    // Adaptive random topology: redraw the informants after an iteration
+    // that brought no improvement.
+    if (topology_kind == TopologyKind::Dynamic && !gbest_improved) {
+        ++topology_epoch;
+        rebuild_topology();
     }
 }
 
-int PSO::get_local_best_index(int i) {
-    double best_fit = (minimize ? std::numeric_limits<double>::max() : std::numeric_limits<double>::lowest());
-    int best_idx = i;
-    for (int offset = -neighbor_size; offset <= neighbor_size; ++offset) {
-        int idx = (i + offset + num_individuals) % num_individuals;
-        double fit = pbest_fitness[idx];
-        if ((minimize && fit < best_fit) || (!minimize && fit > best_fit)) {
-            best_fit = fit;
-            best_idx = idx;
+void PSO::update_positions(int /*iteration*/) {
+    (this->*update_positions_fn)();
+}
+
+template <typename T, bool Global>
+void PSO::update_positions_with() {
+    ++rng_step;
+    PSOUpdateParams params{w, c1, c2, v_max, lower_bound, upper_bound};
+    parallel_rows(num_individuals, [&](int begin, int end) {
+        std::vector<T> r1(dim), r2(dim);
+        for (int i = begin; i < end; ++i) {
+            RandomStream stream(rng_seed, rng_step, i);
+            update_particle_with<T, Global>(params, i, stream, r1.data(), r2.data());
         }
+    });
+}
+
+template <typename T>
+void PSO::update_particle(const PSOUpdateParams& params, int i, RandomStream& stream, T* r1, T* r2) {
+    if (topology.is_global()) {
+        update_particle_with<T, true>(params, i, stream, r1, r2);
+    } else {
+        update_particle_with<T, false>(params, i, stream, r1, r2);
     }
-    return best_idx;
 }
 
-void PSO::update_inertia(int iteration, int total_iters) {
-    double ratio = static_cast<double>(iteration) / (total_iters - 1);
-    w = w_start + ratio * (w_end - w_start);
+template <typename T, bool Global>
+void PSO::update_particle_with(const PSOUpdateParams& params, int i, RandomStream& stream, T* r1, T* r2) {
+    BasicPopulation<T>& pbest = by_precision<T>(pbest_positions, pbest_positions32);
+    const T* best = Global ? by_precision<T>(gbest_position, gbest_position32).data()
+                           : pbest.row(topology.best(i)).data();
+    stream.fill_uniform(r1, dim);
+    stream.fill_uniform(r2, dim);
+    by_precision<T>(update_kernel, update_kernel32)(
+        params, dim, by_precision<T>(positions, positions32).row(i).data(),
+        by_precision<T>(velocities, velocities32).row(i).data(), pbest.row(i).data(), best, r1, r2);
+}
+
+void PSO::replace_individual(int i, const double* genome, double fit) {
+    if (precision == Precision::Float32) {
+        std::copy(genome, genome + dim, positions32.row(i).data());
+        std::fill(velocities32.row(i).begin(), velocities32.row(i).end(), 0.0f);
+    } else {
+        std::copy(genome, genome + dim, positions.row(i).data());
+        std::fill(velocities.row(i).begin(), velocities.row(i).end(), 0.0);
+    }
+    fitness[i] = fit;
+    improve_personal_best(i, fit);
 }
 
-void PSO::clamp_velocity(std::vector<double>& velocity) {
-    for (int d = 0; d < dim; ++d) {
-        if (velocity[d] > v_max) velocity[d] = v_max;
-        if (velocity[d] < -v_max) velocity[d] = -v_max;
+void PSO::begin_async() {
+    idle_particles.clear();
+    for (int i = 0; i < num_individuals; ++i) {
+        idle_particles.push_back(i);
+    }
+    if (precision == Precision::Float32) {
+        async_r1_32.resize(dim);
+        async_r2_32.resize(dim);
+    } else {
+        async_r1.resize(dim);
+        async_r2.resize(dim);
     }
 }
 
-void PSO::enforce_bounds(std::vector<double>& individual) {
-    for (int d = 0; d < dim; ++d) {
-        if (individual[d] < lower_bound) individual[d] = lower_bound;
-        if (individual[d] > upper_bound) individual[d] = upper_bound;
+int PSO::propose_async(double* candidate) {
+    if (idle_particles.empty()) {
+        return -1;
+    }
+    int i = idle_particles.front();
+    idle_particles.pop_front();
+    if (use_w_decrement) {
+        update_inertia(iteration, horizon);
+    }
+    // Move this particle alone, against the best known right now.
+    PSOUpdateParams params{w, c1, c2, v_max, lower_bound, upper_bound};
+    RandomStream stream(rng_seed, async_step++, i, STEADY_STATE_LANE);
+    if (precision == Precision::Float32) {
+        update_particle(params, i, stream, async_r1_32.data(), async_r2_32.data());
+        RowSpan<float> x = positions32.row(i);
+        std::copy(x.begin(), x.end(), candidate);
+    } else {
+        update_particle(params, i, stream, async_r1.data(), async_r2.data());
+        RowSpan<double> x = positions.row(i);
+        std::copy(x.begin(), x.end(), candidate);
     }
+    return i;
 }
 
-std::vector<double> PSO::get_best_solution() const {
+void PSO::accept_async(int i, const double* /*candidate*/, double fit) {
+    fitness[i] = fit;
+    improve_personal_best(i, fit);
+    idle_particles.push_back(i);
+}
+
+void PSO::update_inertia(int iteration, int total_iters) {
+    // Clamped, so a schedule of one iteration or a step past the end holds w_end.
+    double ratio = total_iters > 1 ? std::min(1.0, static_cast<double>(iteration) / (total_iters - 1)) : 1.0;
+    w = w_start + ratio * (w_end - w_start);
+}
+
+const std::vector<double>& PSO::get_best_solution() const {
     return gbest_position;
 }
 
@@ -188,6 +326,86 @@ double PSO::get_best_fitness() const {
     return gbest_fitness;
 }
 
-std::vector<std::vector<std::vector<double>>> PSO::get_population_history() const {
-    return population_history;
+const Population& PSO::get_population() const {
+    return precision == Precision::Float32 ? widened(positions32) : positions;
+}
+
+const Population32* PSO::get_population32() const {
+    return precision == Precision::Float32 ? &positions32 : nullptr;
+}
+
+const std::vector<double>& PSO::get_fitness() const {
+    return fitness;
+}
+
+std::vector<double>& PSO::fitness_buffer() {
+    return fitness;
+}
+
+void PSO::save_state(CheckpointWriter& out) const {
+    out.write(c1);
+    out.write(c2);
+    out.write(w);
+    out.write(v_max);
+    out.write(static_cast<uint8_t>(velocity_init_random));
+    out.write(static_cast<uint8_t>(topology_kind));
+    out.write(static_cast<int32_t>(neighbor_size));
+    out.write(static_cast<uint8_t>(use_w_decrement));
+    out.write(w_start);
+    out.write(w_end);
+    out.write(gbest_fitness);
+    // Particle arrays are stored in the precision they are kept in.
+    if (precision == Precision::Float32) {
+        out.write_array(positions32.data(), positions32.size());
+        out.write_array(velocities32.data(), velocities32.size());
+        out.write_array(pbest_positions32.data(), pbest_positions32.size());
+    } else {
+        out.write_array(positions.data(), positions.size());
+        out.write_array(velocities.data(), velocities.size());
+        out.write_array(pbest_positions.data(), pbest_positions.size());
+    }
+    out.write_array(pbest_fitness);
+    out.write_array(fitness);
+    out.write_array(gbest_position);
+    out.write(topology_epoch);
+}
+
+void PSO::load_state(CheckpointReader& in) {
+    c1 = in.read<double>();
+    c2 = in.read<double>();
+    w = in.read<double>();
+    v_max = in.read<double>();
+    velocity_init_random = in.read<uint8_t>() != 0;
+    uint8_t kind = in.read<uint8_t>();
+    if (kind > static_cast<uint8_t>(TopologyKind::Dynamic)) {
+        throw std::runtime_error("Checkpoint has an unknown PSO topology.");
+    }
+    topology_kind = static_cast<TopologyKind>(kind);
+    neighbor_size = in.read<int32_t>();
+    if (neighbor_size < 0 || neighbor_size > max_neighbor_size(topology_kind, num_individuals)) {
+        throw std::runtime_error("Checkpoint is truncated or corrupt.");
+    }
+    use_w_decrement = in.read<uint8_t>() != 0;
+    w_start = in.read<double>();
+    w_end = in.read<double>();
+    gbest_fitness = in.read<double>();
+    if (precision == Precision::Float32) {
+        in.read_into(positions32.data(), positions32.size());
+        in.read_into(velocities32.data(), velocities32.size());
+        in.read_into(pbest_positions32.data(), pbest_positions32.size());
+    } else {
+        in.read_into(positions.data(), positions.size());
+        in.read_into(velocities.data(), velocities.size());
+        in.read_into(pbest_positions.data(), pbest_positions.size());
+    }
+    in.read_into(pbest_fitness);
+    in.read_into(fitness);
+    in.read_into(gbest_position);
+    if (precision == Precision::Float32) {
+        gbest_position32.assign(gbest_position.begin(), gbest_position.end());
+    }
+    // Version 1 predates the other topologies; its ring and global ones have epoch 0.
+    topology_epoch = in.header().version >= 2 ? in.read<uint64_t>() : 0;
+    rebuild_topology();
+    select_kernels();
 }
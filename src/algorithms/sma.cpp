@@ -1,8 +1,9 @@
 #include "../../include/sma.h"
 #include "../../include/base_optimizer.h"
-#include <iostream>
+#include "../../include/kernels.h"
 #include <limits>
-#include <random>
+#include <algorithm>
+#include <type_traits>
 
 SMA::SMA(int num_individuals,
          int dim,
@@ -19,123 +20,156 @@ SMA::SMA(int num_individuals,
          double w_start,
          double w_end,
          bool store_history_each_iter)
-    : BaseOptimizer(num_individuals, dim, lower_bound, upper_bound),
-      max_iter(max_iter),
+    : BaseOptimizer(num_individuals, dim, lower_bound, upper_bound,
+                    max_iter, minimize, verbose, store_history_each_iter),
       c1(c1),
       c2(c2),
       w(w),
-      minimize(minimize),
-      verbose(verbose),
       random_init_positions(random_init_positions),
       use_w_decrement(use_w_decrement),
       w_start(w_start),
-      w_end(w_end),
-      store_history_each_iter(store_history_each_iter),
-      rng(seed)
+      w_end(w_end)
 {
-    positions.resize(num_individuals, std::vector<double>(dim));
+    rng_seed = static_cast<uint64_t>(seed);
+    positions.resize(num_individuals, dim);
     fitness.resize(num_individuals);
     best_position.resize(dim);
     best_fitness = (minimize
         ? std::numeric_limits<double>::max()
         : std::numeric_limits<double>::lowest());
     initialize_positions();
+    select_kernels();
+}
+
+void SMA::precision_changed() {
+    positions.resize(num_individuals, dim);
+    initialize_positions();
+    select_kernels();
+}
+
+void SMA::select_kernels() {
+    update_kernel = select_sma_kernel(dim);
+    update_kernel32 = select_sma_kernel32();
+    if (precision == Precision::Float32) {
+        absorb_fn = minimize ? &SMA::absorb_with<float, Minimize> : &SMA::absorb_with<float, Maximize>;
+    } else {
+        absorb_fn = minimize ? &SMA::absorb_with<double, Minimize> : &SMA::absorb_with<double, Maximize>;
+    }
 }
 
 void SMA::initialize_positions() {
     if (random_init_positions) {
-        std::uniform_real_distribution<double> dist(lower_bound, upper_bound);
         for (int i = 0; i < num_individuals; ++i) {
-            for (int d = 0; d < dim; ++d) {
-                positions[i][d] = dist(rng);
+            RandomStream stream(rng_seed, 0, i);
+            for (double& x : positions.row(i)) {
+                x = stream.uniform(lower_bound, upper_bound);
             }
         }
     } else {
-        for (int i = 0; i < num_individuals; ++i) {
-            for (int d = 0; d < dim; ++d) {
-                positions[i][d] = 0.0;
-            }
-        }
+        // All-zero start, clamped in case the bounds exclude the origin.
+        double start = std::min(std::max(0.0, lower_bound), upper_bound);
+        std::fill(positions.data(), positions.data() + static_cast<size_t>(num_individuals) * dim, start);
+    }
+
+    // Float32 mode: the same draws, rounded.
+    if (precision == Precision::Float32) {
+        positions32.assign_from(positions);
+        best_position32.assign(dim, 0.0f);
+        positions.release();
+    } else {
+        positions32.release();
+        best_position32.clear();
+        best_position32.shrink_to_fit();
     }
 }
 
-void SMA::set_objective(std::function<double(const std::vector<double>&)> obj) {
-    objective_function = obj;
+void SMA::absorb_initial() {
+    absorb();
 }
 
-void SMA::optimize(int iterations) {
-    if (!objective_function) {
-        throw std::runtime_error("Objective function not set!");
+void SMA::generate() {
+    if (use_w_decrement) {
+        update_inertia(iteration, horizon);
     }
-    int iter_limit = (iterations == -1) ? max_iter : iterations;
-    // Evaluate initial population and set best solution.
+    update_positions(iteration);
+}
+
+void SMA::absorb() {
+    (this->*absorb_fn)();
+}
+
+template <typename T, typename Direction>
+void SMA::absorb_with() {
+    const BasicPopulation<T>& x = by_precision<T>(positions, positions32);
+    int best = -1;
     for (int i = 0; i < num_individuals; ++i) {
-        double fit = objective_function(positions[i]);
-        fitness[i] = fit;
-        if ((minimize && fit < best_fitness) ||
-            (!minimize && fit > best_fitness)) {
+        double fit = fitness[i];
+        if (Direction::better(fit, best_fitness)) {
             best_fitness = fit;
-            best_position = positions[i];
+            best = i;
         }
     }
-    if (store_history_each_iter) {
-        population_history.push_back(positions);
-    }
-    for (int iter = 0; iter < iter_limit; ++iter) {
-        if (use_w_decrement) {
-            update_inertia(iter, iter_limit);
-        }
-        update_positions(iter);
-        for (int i = 0; i < num_individuals; ++i) {
-            double fit = objective_function(positions[i]);
-            fitness[i] = fit;
-            if ((minimize && fit < best_fitness) ||
-                (!minimize && fit > best_fitness)) {
-                best_fitness = fit;
-                best_position = positions[i];
-            }
-        }
-        if (verbose) {
-            std::cout << "Iteration " << (iter + 1)
-                      << " Best Fitness: " << best_fitness << std::endl;
-        }
-        if (store_history_each_iter) {
-            population_history.push_back(positions);
+    if (best >= 0) {
+        x.copy_row_to(best, best_position);
+        if constexpr (std::is_same<T, float>::value) {
+            x.copy_row_to(best, best_position32);
         }
     }
-    if (!store_history_each_iter) {
-        population_history.push_back(positions);
-    }
 }
 
-void SMA::update_positions(int iteration) {
-    std::uniform_real_distribution<double> dist01(0.0, 1.0);
-    for (int i = 0; i < num_individuals; ++i) {
-        for (int d = 0; d < dim; ++d) {
-            double factor1 = c1 * dist01(rng);
-            double factor2 = c2 * ((dist01(rng) * 2.0) - 1.0);
-            double delta = factor1 * (best_position[d] - positions[i][d]) + factor2;
-            positions[i][d] += w * delta;
-            enforce_bounds(positions[i]);
+void SMA::replace_individual(int i, const double* genome, double fit) {
+    if (precision == Precision::Float32) {
+        std::copy(genome, genome + dim, positions32.row(i).data());
+    } else {
+        std::copy(genome, genome + dim, positions.row(i).data());
+    }
+    fitness[i] = fit;
+    if ((minimize && fit < best_fitness) || (!minimize && fit > best_fitness)) {
+        best_fitness = fit;
+        if (precision == Precision::Float32) {
+            positions32.copy_row_to(i, best_position);
+            positions32.copy_row_to(i, best_position32);
+        } else {
+            positions.copy_row_to(i, best_position);
         }
     }
 }
 
-void SMA::enforce_bounds(std::vector<double>& individual) {
-    for (int d = 0; d < dim; ++d) {
-        if (individual[d] < lower_bound)
-            individual[d] = lower_bound;
-        if (individual[d] > upper_bound)
-            individual[d] = upper_bound;
+void SMA::update_positions(int /*iteration*/) {
+    if (precision == Precision::Float32) {
+        update_positions_with<float>();
+    } else {
+        update_positions_with<double>();
     }
+    // Also a public entry point: the widened copy must follow the move.
+    population_changed();
+}
+
+template <typename T>
+void SMA::update_positions_with() {
+    ++rng_step;
+    SMAUpdateParams params{c1, c2, w, lower_bound, upper_bound};
+    BasicPopulation<T>& x = by_precision<T>(positions, positions32);
+    const T* best = by_precision<T>(best_position, best_position32).data();
+    auto kernel = by_precision<T>(update_kernel, update_kernel32);
+    parallel_rows(num_individuals, [&](int begin, int end) {
+        std::vector<T> r1(dim), r2(dim);
+        for (int i = begin; i < end; ++i) {
+            RandomStream stream(rng_seed, rng_step, i);
+            stream.fill_uniform(r1.data(), dim);
+            stream.fill_uniform(r2.data(), dim);
+            kernel(params, dim, x.row(i).data(), best, r1.data(), r2.data());
+        }
+    });
 }
 
 void SMA::update_inertia(int iteration, int total_iters) {
-    double ratio = static_cast<double>(iteration) / (total_iters - 1);
+    // Clamped, so a schedule of one iteration or a step past the end holds w_end.
+    double ratio = total_iters > 1 ? std::min(1.0, static_cast<double>(iteration) / (total_iters - 1)) : 1.0;
     w = w_start + ratio * (w_end - w_start);
 }
 
-std::vector<double> SMA::get_best_solution() const {
+const std::vector<double>& SMA::get_best_solution() const {
     return best_position;
 }
 
@@ -143,6 +177,58 @@ double SMA::get_best_fitness() const {
     return best_fitness;
 }
 
-std::vector<std::vector<std::vector<double>>> SMA::get_population_history() const {
-    return population_history;
+const Population& SMA::get_population() const {
+    return precision == Precision::Float32 ? widened(positions32) : positions;
+}
+
+const Population32* SMA::get_population32() const {
+    return precision == Precision::Float32 ? &positions32 : nullptr;
+}
+
+const std::vector<double>& SMA::get_fitness() const {
+    return fitness;
+}
+
+std::vector<double>& SMA::fitness_buffer() {
+    return fitness;
+}
+
+void SMA::save_state(CheckpointWriter& out) const {
+    out.write(c1);
+    out.write(c2);
+    out.write(w);
+    out.write(static_cast<uint8_t>(random_init_positions));
+    out.write(static_cast<uint8_t>(use_w_decrement));
+    out.write(w_start);
+    out.write(w_end);
+    out.write(best_fitness);
+    if (precision == Precision::Float32) {
+        out.write_array(positions32.data(), positions32.size());
+    } else {
+        out.write_array(positions.data(), positions.size());
+    }
+    out.write_array(fitness);
+    out.write_array(best_position);
+}
+
+void SMA::load_state(CheckpointReader& in) {
+    c1 = in.read<double>();
+    c2 = in.read<double>();
+    w = in.read<double>();
+    random_init_positions = in.read<uint8_t>() != 0;
+    use_w_decrement = in.read<uint8_t>() != 0;
+    w_start = in.read<double>();
+    w_end = in.read<double>();
+    best_fitness = in.read<double>();
+    if (precision == Precision::Float32) {
+        in.read_into(positions32.data(), positions32.size());
+    } else {
+        in.read_into(positions.data(), positions.size());
+    }
+    in.read_into(fitness);
+    in.read_into(best_position);
+    if (precision == Precision::Float32) {
+        best_position32.assign(best_position.begin(), best_position.end());
+    }
+    select_kernels();
 }
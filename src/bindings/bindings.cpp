@@ -1,24 +1,662 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include "../../include/base_optimizer.h"
+#include "../../include/benchmark_functions.h"
 #include "../../include/sma.h"
 #include "../../include/pso.h"
 #include "../../include/ga.h"
+#include "../../include/island_model.h"
+#include "../../include/multi_run.h"
 
 namespace py = pybind11;
 
+using FitnessArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// Keeps a Python callable alive inside std::function copies. The optimizer
+// runs without the GIL, so the last reference must re-acquire it to release.
+static std::shared_ptr<py::function> hold_callable(py::function func) {
+    return std::shared_ptr<py::function>(new py::function(std::move(func)), [](py::function* f) {
+        py::gil_scoped_acquire gil;
+        delete f;
+    });
+}
+
+// Optimizers join the threads of evaluations abandoned by an asynchronous
+// timeout when destroyed, and such a thread may need the GIL to return from
+// a Python objective: the GIL is released while an optimizer is deleted.
+template <typename T>
+struct ReleaseGilDelete {
+    void operator()(T* optimizer) const {
+        py::gil_scoped_release release;
+        delete optimizer;
+    }
+};
+
+template <typename T>
+using OptimizerHolder = std::unique_ptr<T, ReleaseGilDelete<T>>;
+
+// Optimizers run with the GIL released, so another Python thread can call
+// in mid-run. Every method claims its object for the calling thread (runners
+// also claim their optimizers), and a call from any other thread while a
+// claim is held raises RuntimeError instead of racing. Claims nest, and a
+// progress callback borrows the claim on its optimizer, so callbacks may
+// call back in even when they fire on an island or worker thread.
+namespace {
+
+struct ClaimState {
+    std::thread::id owner;
+    int depth = 0;
+    std::vector<std::thread::id> borrowers;
+};
+
+std::mutex claims_mutex;
+std::unordered_map<const void*, ClaimState> claims;
+
+class Claim {
+public:
+    explicit Claim(std::vector<const void*> objects) : keys(std::move(objects)) {
+        std::thread::id me = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(claims_mutex);
+        for (const void* key : keys) {
+            auto it = claims.find(key);
+            if (it != claims.end() && it->second.owner != me &&
+                std::find(it->second.borrowers.begin(), it->second.borrowers.end(), me) ==
+                    it->second.borrowers.end()) {
+                throw std::runtime_error("Optimizer is in use by another thread.");
+            }
+        }
+        for (const void* key : keys) {
+            ClaimState& state = claims[key];
+            if (state.depth++ == 0) {
+                state.owner = me;
+            }
+        }
+    }
+
+    ~Claim() {
+        std::lock_guard<std::mutex> lock(claims_mutex);
+        for (const void* key : keys) {
+            auto it = claims.find(key);
+            if (--it->second.depth == 0 && it->second.borrowers.empty()) {
+                claims.erase(it);
+            }
+        }
+    }
+
+    Claim(const Claim&) = delete;
+    Claim& operator=(const Claim&) = delete;
+
+private:
+    std::vector<const void*> keys;
+};
+
+// Lets the calling thread use an object claimed by another thread.
+class Borrow {
+public:
+    explicit Borrow(const void* object) : key(object), me(std::this_thread::get_id()) {
+        std::lock_guard<std::mutex> lock(claims_mutex);
+        claims[key].borrowers.push_back(me);
+    }
+
+    ~Borrow() {
+        std::lock_guard<std::mutex> lock(claims_mutex);
+        auto it = claims.find(key);
+        std::vector<std::thread::id>& borrowers = it->second.borrowers;
+        borrowers.erase(std::find(borrowers.begin(), borrowers.end(), me));
+        if (it->second.depth == 0 && borrowers.empty()) {
+            claims.erase(it);
+        }
+    }
+
+    Borrow(const Borrow&) = delete;
+    Borrow& operator=(const Borrow&) = delete;
+
+private:
+    const void* key;
+    std::thread::id me;
+};
+
+std::vector<const void*> claim_keys(const BaseOptimizer& self) {
+    return {&self};
+}
+
+std::vector<const void*> claim_keys(const py::object& self) {
+    return claim_keys(self.cast<const BaseOptimizer&>());
+}
+
+std::vector<const void*> claim_keys(const IslandModel& self) {
+    std::vector<const void*> keys{&self};
+    for (int k = 0; k < self.size(); ++k) {
+        keys.push_back(static_cast<const BaseOptimizer*>(&self.get_island(k)));
+    }
+    return keys;
+}
+
+std::vector<const void*> claim_keys(const MultiRun& self) {
+    std::vector<const void*> keys{&self};
+    for (int k = 0; k < self.size(); ++k) {
+        keys.push_back(static_cast<const BaseOptimizer*>(&self.get_run(k)));
+    }
+    return keys;
+}
+
+// Plain function type of a bound callable: self first for member functions.
+template <typename F>
+struct lambda_signature;
+template <typename C, typename R, typename... Args>
+struct lambda_signature<R (C::*)(Args...) const> {
+    using type = R (*)(Args...);
+};
+
+template <typename F>
+struct bound_signature {
+    using type = typename lambda_signature<decltype(&F::operator())>::type;
+};
+template <typename R, typename... Args>
+struct bound_signature<R (*)(Args...)> {
+    using type = R (*)(Args...);
+};
+template <typename C, typename R, typename... Args>
+struct bound_signature<R (C::*)(Args...)> {
+    using type = R (*)(C&, Args...);
+};
+template <typename C, typename R, typename... Args>
+struct bound_signature<R (C::*)(Args...) const> {
+    using type = R (*)(const C&, Args...);
+};
+
+template <typename F, typename R, typename Self, typename... Args>
+auto exclusive_as(F f, R (*)(Self, Args...)) {
+    return [f](Self self, Args... args) -> R {
+        Claim claim(claim_keys(self));
+        return std::invoke(f, self, std::forward<Args>(args)...);
+    };
+}
+
+// Wrap a method so it holds a claim on its object while it runs.
+template <typename F>
+auto exclusive(F f) {
+    return exclusive_as(f, static_cast<typename bound_signature<F>::type>(nullptr));
+}
+
+}  // namespace
+
+// A Python objective may run on several threads when it says so via the
+// thread_safe argument or a truthy `thread_safe` attribute, or when the
+// interpreter is a free-threaded build.
+static bool is_thread_safe(const py::function& func, const py::object& thread_safe) {
+    if (!thread_safe.is_none()) {
+        return thread_safe.cast<bool>();
+    }
+#ifdef Py_GIL_DISABLED
+    return true;
+#else
+    return py::getattr(func, "thread_safe", py::bool_(false)).cast<bool>();
+#endif
+}
+
+// Wrap a Python callable taking a list of floats; the GIL is held only for the call.
+static void set_objective(BaseOptimizer& self, py::function func, py::object thread_safe) {
+    bool parallel = is_thread_safe(func, thread_safe);
+    std::shared_ptr<py::function> callable = hold_callable(std::move(func));
+    self.set_objective([callable](const std::vector<double>& x) {
+        py::gil_scoped_acquire gil;
+        return (*callable)(x).cast<double>();
+    }, parallel);
+}
+
+// Batch objective handing the Python callable an (N x dim) array of T.
+template <typename T>
+static std::function<void(const T*, int, int, double*)> batch_objective(std::shared_ptr<py::function> callable) {
+    return [callable](const T* positions, int count, int dim, double* fitness) {
+        py::gil_scoped_acquire gil;
+        py::array_t<T> batch({static_cast<py::ssize_t>(count), static_cast<py::ssize_t>(dim)});
+        std::copy(positions, positions + static_cast<size_t>(count) * dim, batch.mutable_data());
+        FitnessArray result = (*callable)(batch).cast<FitnessArray>();
+        if (result.size() != count) {
+            throw std::runtime_error("Batch objective must return one fitness value per individual.");
+        }
+        std::copy(result.data(), result.data() + count, fitness);
+    };
+}
+
+// Wrap a Python callable taking an (N x dim) array and returning N fitness
+// values. In float32 mode the array is float32.
+static void set_batch_objective(BaseOptimizer& self, py::function func) {
+    std::shared_ptr<py::function> callable = hold_callable(std::move(func));
+    self.set_batch_objective(batch_objective<double>(callable), batch_objective<float>(callable));
+}
+
+// Read-only NumPy view of optimizer-owned memory. The array holds a reference
+// to `owner`, so the memory outlives every view. Contents follow the
+// optimizer's state as it keeps running; call .copy() to keep a snapshot.
+template <typename T>
+static py::array view_of(const T* data, std::vector<py::ssize_t> shape, py::handle owner) {
+    py::array_t<T> array(shape, data, owner);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+// Number of live views of each optimizer's memory. set_precision()
+// reallocates that memory, so it is refused while any view is alive.
+// Only touched with the GIL held.
+static std::unordered_map<const BaseOptimizer*, int> live_views;
+
+struct ViewOwner {
+    py::object optimizer;
+    const BaseOptimizer* key;
+};
+
+// View of memory owned by the optimizer `self`, counted in live_views.
+template <typename T>
+static py::array optimizer_view(const T* data, std::vector<py::ssize_t> shape, py::object self) {
+    const BaseOptimizer* key = &self.cast<const BaseOptimizer&>();
+    ++live_views[key];
+    py::capsule owner(new ViewOwner{self, key}, [](void* p) {
+        ViewOwner* view = static_cast<ViewOwner*>(p);
+        if (--live_views[view->key] == 0) {
+            live_views.erase(view->key);
+        }
+        delete view;
+    });
+    return view_of(data, std::move(shape), owner);
+}
+
+static void require_no_views(const BaseOptimizer& self, const char* what) {
+    if (live_views.count(&self)) {
+        throw std::runtime_error(std::string(what) + " would free memory that NumPy views of this optimizer "
+                                 "still use; delete them (or keep .copy()s) first.");
+    }
+}
+
+static void set_precision(BaseOptimizer& self, Precision precision) {
+    if (precision != self.get_precision()) {
+        require_no_views(self, "set_precision()");
+    }
+    self.set_precision(precision);
+}
+
+// A checkpoint may switch PSO and SMA to the other precision.
+static void load_checkpoint(BaseOptimizer& self, const std::string& path) {
+    if (dynamic_cast<PSO*>(&self) || dynamic_cast<SMA*>(&self)) {
+        require_no_views(self, "load_checkpoint()");
+    }
+    py::gil_scoped_release release;
+    self.load_checkpoint(path);
+}
+
+static py::array get_best_solution(py::object self) {
+    const std::vector<double>& best = self.cast<const BaseOptimizer&>().get_best_solution();
+    return optimizer_view(best.data(), {static_cast<py::ssize_t>(best.size())}, self);
+}
+
+// float32 in float32 mode.
+static py::array get_population(py::object self) {
+    const BaseOptimizer& optimizer = self.cast<const BaseOptimizer&>();
+    if (const Population32* narrow = optimizer.get_population32()) {
+        return optimizer_view(narrow->data(), {narrow->rows(), narrow->cols()}, self);
+    }
+    const Population& population = optimizer.get_population();
+    return optimizer_view(population.data(), {population.rows(), population.cols()}, self);
+}
+
+static py::array get_fitness(py::object self) {
+    const std::vector<double>& fitness = self.cast<const BaseOptimizer&>().get_fitness();
+    return optimizer_view(fitness.data(), {static_cast<py::ssize_t>(fitness.size())}, self);
+}
+
+// The candidates are computed without the GIL; the returned view (float32
+// in float32 mode) is only valid until the next ask().
+static py::array ask(py::object self) {
+    BaseOptimizer& optimizer = self.cast<BaseOptimizer&>();
+    if (optimizer.get_precision() == Precision::Float32) {
+        const Population32* candidates;
+        {
+            py::gil_scoped_release release;
+            candidates = &optimizer.ask32();
+        }
+        return optimizer_view(candidates->data(), {candidates->rows(), candidates->cols()}, self);
+    }
+    const Population* candidates;
+    {
+        py::gil_scoped_release release;
+        candidates = &optimizer.ask();
+    }
+    return optimizer_view(candidates->data(), {candidates->rows(), candidates->cols()}, self);
+}
+
+static void tell(BaseOptimizer& self, FitnessArray fitness) {
+    if (fitness.ndim() != 1) {
+        throw std::runtime_error("tell() expects a 1-D array of fitness values.");
+    }
+    py::gil_scoped_release release;
+    self.tell(fitness.data(), static_cast<int>(fitness.size()));
+}
+
+// History views own a reference to the snapshot buffer they were taken from,
+// so they stay valid (and unchanged) when later snapshots are recorded.
+template <typename T>
+static py::array history_view(const HistorySlice<T>& slice, std::vector<py::ssize_t> shape) {
+    shape.insert(shape.begin(), slice.size);
+    if (!slice.buffer) {
+        return py::array_t<T>(shape);
+    }
+    auto* holder = new std::shared_ptr<const std::vector<T>>(slice.buffer);
+    py::capsule owner(holder, [](void* p) {
+        delete static_cast<std::shared_ptr<const std::vector<T>>*>(p);
+    });
+    return view_of(slice.data, shape, owner);
+}
+
+static py::array get_population_history(const BaseOptimizer& self) {
+    const History& history = self.get_history();
+    return history_view(history.get_positions(), {history.rows(), history.cols()});
+}
+
+static py::array get_fitness_history(const BaseOptimizer& self) {
+    const History& history = self.get_history();
+    return history_view(history.get_fitness(), {history.rows()});
+}
+
+static py::array get_best_fitness_history(const BaseOptimizer& self) {
+    return history_view(self.get_history().get_best_fitness(), {});
+}
+
+static py::array get_history_generations(const BaseOptimizer& self) {
+    return history_view(self.get_history().get_generations(), {});
+}
+
+static void configure_history(BaseOptimizer& self, int capacity, int stride,
+                              bool record_positions, const std::string& spill_path) {
+    HistoryOptions options;
+    options.capacity = capacity;
+    options.stride = stride;
+    options.record_positions = record_positions;
+    options.spill_path = spill_path;
+    self.configure_history(options);
+}
+
+// target_fitness=None disables the target rule.
+static void set_termination(BaseOptimizer& self, uint64_t max_evaluations, double max_seconds,
+                            py::object target_fitness, int stagnation_window,
+                            double stagnation_epsilon, double min_diversity) {
+    TerminationCriteria criteria;
+    criteria.max_evaluations = max_evaluations;
+    criteria.max_seconds = max_seconds;
+    criteria.has_target = !target_fitness.is_none();
+    if (criteria.has_target) {
+        criteria.target_fitness = target_fitness.cast<double>();
+    }
+    criteria.stagnation_window = stagnation_window;
+    criteria.stagnation_epsilon = stagnation_epsilon;
+    criteria.min_diversity = min_diversity;
+    self.set_termination(criteria);
+}
+
+// The callback receives the optimizer and may return True to stop; None
+// removes it. The GIL is held only for the call.
+static void set_progress_callback(BaseOptimizer& self, py::object func, int every) {
+    if (func.is_none()) {
+        self.set_progress_callback(nullptr, every);
+        return;
+    }
+    std::shared_ptr<py::function> callable = hold_callable(func.cast<py::function>());
+    self.set_progress_callback([callable](const BaseOptimizer& optimizer) {
+        Borrow borrow(&optimizer);
+        py::gil_scoped_acquire gil;
+        py::object result = (*callable)(py::cast(const_cast<BaseOptimizer*>(&optimizer),
+                                                 py::return_value_policy::reference));
+        return !result.is_none() && result.cast<bool>();
+    }, every);
+}
+
+// Instrumentation arrays are copies: the statistics keep growing while the
+// optimizer runs, so views into them could dangle.
+template <typename T, typename Container>
+static py::array copy_of(const Container& values) {
+    return py::array_t<T>(static_cast<py::ssize_t>(values.size()), values.data());
+}
+
+// Rows of the last ask() that need evaluating; tell() ignores the others.
+static py::array get_candidate_rows(const BaseOptimizer& self) {
+    if (const std::vector<int>* rows = self.candidate_rows()) {
+        return copy_of<int>(*rows);
+    }
+    std::vector<int> all(self.get_num_individuals());
+    for (int i = 0; i < static_cast<int>(all.size()); ++i) {
+        all[i] = i;
+    }
+    return copy_of<int>(all);
+}
+
+static py::array get_phase_times(const BaseOptimizer& self) {
+    return copy_of<double>(self.get_instrumentation().get_phase_seconds());
+}
+
+static py::array get_phase_calls(const BaseOptimizer& self) {
+    return copy_of<uint64_t>(self.get_instrumentation().get_phase_calls());
+}
+
+static py::dict get_statistics(const BaseOptimizer& self) {
+    const Instrumentation& stats = self.get_instrumentation();
+    py::dict result;
+    result["iteration"] = copy_of<int>(stats.get_iterations());
+    result["best_fitness"] = copy_of<double>(stats.get_best());
+    result["mean_fitness"] = copy_of<double>(stats.get_mean());
+    result["diversity"] = copy_of<double>(stats.get_diversity());
+    result["evaluations"] = copy_of<uint64_t>(stats.get_evaluations());
+    return result;
+}
+
+// Address held by a PyCapsule, a plain integer, a Numba cfunc (its `address`)
+// or a ctypes object (function pointer, c_void_p, pointer or buffer).
+static void* native_pointer(const py::object& obj) {
+    if (obj.is_none()) {
+        return nullptr;
+    }
+    if (PyCapsule_CheckExact(obj.ptr())) {
+        void* pointer = PyCapsule_GetPointer(obj.ptr(), PyCapsule_GetName(obj.ptr()));
+        if (!pointer) {
+            throw py::error_already_set();
+        }
+        return pointer;
+    }
+    if (py::isinstance<py::int_>(obj)) {
+        return reinterpret_cast<void*>(obj.cast<uintptr_t>());
+    }
+    if (py::hasattr(obj, "address")) {
+        return reinterpret_cast<void*>(obj.attr("address").cast<uintptr_t>());
+    }
+    py::module_ ctypes = py::module_::import("ctypes");
+    py::object address;
+    try {
+        address = ctypes.attr("cast")(obj, ctypes.attr("c_void_p")).attr("value");
+    } catch (py::error_already_set&) {
+        address = ctypes.attr("addressof")(obj);  // Structures and arrays.
+    }
+    return address.is_none() ? nullptr : reinterpret_cast<void*>(address.cast<uintptr_t>());
+}
+
+// `func` must have the C signature double(const double*, size_t, void*). It
+// is called directly from C++, without the GIL; `func` and `user_data` are
+// kept alive while the objective is set.
+template <typename Target>
+static void set_native_objective(Target& self, py::object func, py::object user_data, bool thread_safe) {
+    void* address = native_pointer(func);
+    if (!address) {
+        throw std::runtime_error("Native objective must not be a null pointer.");
+    }
+    void* data = native_pointer(user_data);
+    auto* keep = new py::object(py::make_tuple(func, user_data));
+    std::shared_ptr<const void> owner(keep, [](const void* p) {
+        py::gil_scoped_acquire gil;
+        delete static_cast<const py::object*>(p);
+    });
+    self.set_native_objective(reinterpret_cast<BaseOptimizer::NativeObjective>(address), data, thread_safe, owner);
+}
+
+// Evaluate a benchmark on one point (1-D array) or on one point per row (2-D array).
+static py::object call_benchmark(const BenchmarkFunction& self, FitnessArray x) {
+    if (x.ndim() == 1 && x.shape(0) == self.get_dim()) {
+        return py::float_(self.evaluate(x.data()));
+    }
+    if (x.ndim() == 2 && x.shape(1) == self.get_dim()) {
+        py::array_t<double> fitness(x.shape(0));
+        self.evaluate_batch(x.data(), static_cast<int>(x.shape(0)), self.get_dim(), fitness.mutable_data());
+        return std::move(fitness);
+    }
+    throw std::runtime_error("Benchmark expects an array of shape (dim,) or (n, dim).");
+}
+
+// Pickle support: the pickled state is a checkpoint. Unpickling builds an
+// optimizer of the recorded shape and restores the checkpoint over it; the
+// objective is not part of it and must be set again.
+static py::bytes get_state(const BaseOptimizer& self) {
+    std::vector<unsigned char> bytes = self.serialize();
+    return py::bytes(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+template <typename T, typename Make>
+static OptimizerHolder<T> set_state(const py::bytes& state, Make make) {
+    char* data = nullptr;
+    Py_ssize_t size = 0;
+    if (PyBytes_AsStringAndSize(state.ptr(), &data, &size) != 0) {
+        throw py::error_already_set();
+    }
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    CheckpointReader reader(bytes, static_cast<size_t>(size));
+    std::unique_ptr<T> self = make(reader.header());
+    self->deserialize(bytes, static_cast<size_t>(size));
+    return OptimizerHolder<T>(self.release());
+}
+
+#ifdef Py_GIL_DISABLED
+PYBIND11_MODULE(bioopt, m, py::mod_gil_not_used()) {
+#else
 PYBIND11_MODULE(bioopt, m) {
+#endif
+    py::enum_<StopReason>(m, "StopReason")
+        .value("NotStopped", StopReason::NotStopped)
+        .value("MaxIterations", StopReason::MaxIterations)
+        .value("MaxEvaluations", StopReason::MaxEvaluations)
+        .value("Deadline", StopReason::Deadline)
+        .value("TargetReached", StopReason::TargetReached)
+        .value("Stagnation", StopReason::Stagnation)
+        .value("DiversityCollapse", StopReason::DiversityCollapse)
+        .value("Callback", StopReason::Callback)
+        .def("__str__", [](StopReason reason) { return stop_reason_name(reason); });
+
+    py::enum_<Phase>(m, "Phase")
+        .value("Evaluation", Phase::Evaluation)
+        .value("Update", Phase::Update)
+        .value("Selection", Phase::Selection)
+        .value("Bounds", Phase::Bounds)
+        .value("History", Phase::History)
+        .def("__str__", [](Phase phase) { return phase_name(phase); });
+
+    py::enum_<TopologyKind>(m, "Topology")
+        .value("Global", TopologyKind::Global)
+        .value("Ring", TopologyKind::Ring)
+        .value("VonNeumann", TopologyKind::VonNeumann)
+        .value("RandomRegular", TopologyKind::RandomRegular)
+        .value("Dynamic", TopologyKind::Dynamic)
+        .def("__str__", [](TopologyKind kind) { return topology_name(kind); });
+
+    py::enum_<Precision>(m, "Precision")
+        .value("Float64", Precision::Float64)
+        .value("Float32", Precision::Float32)
+        .def("__str__", [](Precision precision) { return precision_name(precision); });
+
     // BaseOptimizer (abstract)
-    py::class_<BaseOptimizer>(m, "BaseOptimizer")
-        .def("set_objective", &BaseOptimizer::set_objective)
-        .def("optimize", &BaseOptimizer::optimize)
-        .def("get_best_solution", &BaseOptimizer::get_best_solution)
-        .def("get_best_fitness", &BaseOptimizer::get_best_fitness);
+    py::class_<BaseOptimizer, OptimizerHolder<BaseOptimizer>>(m, "BaseOptimizer")
+        .def("set_objective", exclusive(&set_objective), py::arg("func"), py::arg("thread_safe") = py::none())
+        .def("set_batch_objective", exclusive(&set_batch_objective))
+        .def("set_benchmark_objective", exclusive([](BaseOptimizer& self, const BenchmarkFunction& function) {
+            if (function.get_dim() != self.get_dim()) {
+                throw std::runtime_error("Benchmark dimension does not match the optimizer.");
+            }
+            auto copy = std::make_shared<BenchmarkFunction>(function);
+            self.set_native_objective(&BenchmarkFunction::call, copy.get(), true, copy);
+        }), py::arg("benchmark"))
+        .def("set_native_objective", exclusive(&set_native_objective<BaseOptimizer>),
+             py::arg("func"), py::arg("user_data") = py::none(), py::arg("thread_safe") = true)
+        .def("set_num_threads", exclusive(&BaseOptimizer::set_num_threads), py::arg("num_threads"))
+        .def("get_num_threads", exclusive(&BaseOptimizer::get_num_threads))
+        .def("optimize", exclusive(&BaseOptimizer::optimize), py::call_guard<py::gil_scoped_release>())
+        .def("ask", exclusive(&ask))
+        .def("tell", exclusive(&tell), py::arg("fitness"))
+        .def("get_candidate_rows", exclusive(&get_candidate_rows))
+        .def("get_iteration", exclusive(&BaseOptimizer::get_iteration))
+        .def("set_async_mode", exclusive(&BaseOptimizer::set_async_mode),
+             py::arg("enabled"), py::arg("timeout") = 0.0)
+        .def("get_async_mode", exclusive(&BaseOptimizer::get_async_mode))
+        .def("get_failed_evaluations", exclusive(&BaseOptimizer::get_failed_evaluations))
+        .def("set_precision", exclusive(&set_precision), py::arg("precision"))
+        .def("get_precision", exclusive(&BaseOptimizer::get_precision))
+        .def("get_best_solution", exclusive(&get_best_solution))
+        .def("get_best_fitness", exclusive(&BaseOptimizer::get_best_fitness))
+        .def("get_population", exclusive(&get_population))
+        .def("get_fitness", exclusive(&get_fitness))
+        .def("get_population_history", exclusive(&get_population_history))
+        .def("configure_history", exclusive(&configure_history),
+             py::arg("capacity") = -1,
+             py::arg("stride") = 1,
+             py::arg("record_positions") = true,
+             py::arg("spill_path") = "")
+        .def("get_fitness_history", exclusive(&get_fitness_history))
+        .def("get_best_fitness_history", exclusive(&get_best_fitness_history))
+        .def("get_history_generations", exclusive(&get_history_generations))
+        .def("set_fitness_cache", exclusive(&BaseOptimizer::set_fitness_cache), py::arg("capacity"))
+        .def("get_cache_hits", exclusive([](const BaseOptimizer& self) { return self.get_fitness_cache().get_hits(); }))
+        .def("get_cache_misses", exclusive([](const BaseOptimizer& self) { return self.get_fitness_cache().get_misses(); }))
+        .def("set_surrogate", exclusive([](BaseOptimizer& self, int capacity, int neighbors, double evaluate_fraction,
+                                 double explore_fraction, int min_points) {
+            SurrogateSettings settings;
+            settings.capacity = capacity;
+            settings.neighbors = neighbors;
+            settings.evaluate_fraction = evaluate_fraction;
+            settings.explore_fraction = explore_fraction;
+            settings.min_points = min_points;
+            self.set_surrogate(settings);
+        }), py::arg("capacity"), py::arg("neighbors") = 8, py::arg("evaluate_fraction") = 0.25,
+           py::arg("explore_fraction") = 0.05, py::arg("min_points") = 32)
+        .def("get_evaluations_saved", exclusive([](const BaseOptimizer& self) { return self.get_surrogate().get_screened(); }))
+        .def("get_evaluation_count", exclusive(&BaseOptimizer::get_evaluation_count))
+        .def("set_termination", exclusive(&set_termination),
+             py::arg("max_evaluations") = 0,
+             py::arg("max_seconds") = 0.0,
+             py::arg("target_fitness") = py::none(),
+             py::arg("stagnation_window") = 0,
+             py::arg("stagnation_epsilon") = 0.0,
+             py::arg("min_diversity") = 0.0)
+        .def("get_stop_reason", exclusive(&BaseOptimizer::get_stop_reason))
+        .def("save_checkpoint", exclusive(&BaseOptimizer::save_checkpoint), py::arg("path"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("load_checkpoint", exclusive(&load_checkpoint), py::arg("path"))
+        .def("configure_instrumentation", exclusive(&BaseOptimizer::configure_instrumentation),
+             py::arg("timers") = true, py::arg("statistics") = true)
+        .def("get_phase_times", exclusive(&get_phase_times))
+        .def("get_phase_calls", exclusive(&get_phase_calls))
+        .def("get_statistics", exclusive(&get_statistics))
+        .def("set_progress_callback", exclusive(&set_progress_callback),
+             py::arg("callback"), py::arg("every") = 1);
 
     // SMA
-    py::class_<SMA, BaseOptimizer>(m, "SMA")
+    py::class_<SMA, BaseOptimizer, OptimizerHolder<SMA>>(m, "SMA")
         .def(py::init<
             int, int, double, double, int, double, double, double,
             bool, bool, int, bool, bool, double, double, bool
@@ -40,15 +678,27 @@ PYBIND11_MODULE(bioopt, m) {
              py::arg("w_end") = 0.4,
              py::arg("store_history_each_iter") = false
         )
-        .def("set_objective", &SMA::set_objective)
-        .def("optimize", &SMA::optimize, py::arg("iterations") = -1)
-        .def("get_best_solution", &SMA::get_best_solution)
-        .def("get_best_fitness", &SMA::get_best_fitness)
-        .def("get_population_history", &SMA::get_population_history)
-        .def("update_positions", &SMA::update_positions);
+        .def("set_objective", exclusive(&set_objective), py::arg("func"), py::arg("thread_safe") = py::none())
+        .def("set_batch_objective", exclusive(&set_batch_objective))
+        .def("set_num_threads", exclusive(&SMA::set_num_threads), py::arg("num_threads"))
+        .def("get_num_threads", exclusive(&SMA::get_num_threads))
+        .def("optimize", exclusive(&SMA::optimize), py::arg("iterations") = -1,
+             py::call_guard<py::gil_scoped_release>())
+        .def("get_best_solution", exclusive(&get_best_solution))
+        .def("get_best_fitness", exclusive(&SMA::get_best_fitness))
+        .def("get_population", exclusive(&get_population))
+        .def("get_fitness", exclusive(&get_fitness))
+        .def("get_population_history", exclusive(&get_population_history))
+        .def("update_positions", exclusive(&SMA::update_positions), py::call_guard<py::gil_scoped_release>())
+        .def(py::pickle(exclusive(&get_state), [](const py::bytes& state) {
+            return set_state<SMA>(state, [](const CheckpointHeader& h) {
+                return std::unique_ptr<SMA>(new SMA(h.num_individuals, h.dim, h.lower_bound,
+                                                    h.upper_bound, h.max_iter, 0.0, 0.0, 0.0));
+            });
+        }));
 
     // PSO
-    py::class_<PSO, BaseOptimizer>(m, "PSO")
+    py::class_<PSO, BaseOptimizer, OptimizerHolder<PSO>>(m, "PSO")
         .def(py::init<
             int, int, double, double, int, double, double, double, double,
             bool, bool, int, bool, bool, int, bool, double, double, bool
@@ -73,14 +723,29 @@ PYBIND11_MODULE(bioopt, m) {
              py::arg("w_end") = 0.4,
              py::arg("store_history_each_iter") = false
         )
-        .def("set_objective", &PSO::set_objective)
-        .def("optimize", &PSO::optimize, py::arg("iterations") = -1)
-        .def("get_best_solution", &PSO::get_best_solution)
-        .def("get_best_fitness", &PSO::get_best_fitness)
-        .def("get_population_history", &PSO::get_population_history);
+        .def("set_objective", exclusive(&set_objective), py::arg("func"), py::arg("thread_safe") = py::none())
+        .def("set_batch_objective", exclusive(&set_batch_objective))
+        .def("set_num_threads", exclusive(&PSO::set_num_threads), py::arg("num_threads"))
+        .def("get_num_threads", exclusive(&PSO::get_num_threads))
+        .def("set_topology", exclusive(&PSO::set_topology), py::arg("kind"), py::arg("neighbor_size") = 1)
+        .def("get_topology", exclusive(&PSO::get_topology))
+        .def("get_neighbor_size", exclusive(&PSO::get_neighbor_size))
+        .def("optimize", exclusive(&PSO::optimize), py::arg("iterations") = -1,
+             py::call_guard<py::gil_scoped_release>())
+        .def("get_best_solution", exclusive(&get_best_solution))
+        .def("get_best_fitness", exclusive(&PSO::get_best_fitness))
+        .def("get_population", exclusive(&get_population))
+        .def("get_fitness", exclusive(&get_fitness))
+        .def("get_population_history", exclusive(&get_population_history))
+        .def(py::pickle(exclusive(&get_state), [](const py::bytes& state) {
+            return set_state<PSO>(state, [](const CheckpointHeader& h) {
+                return std::unique_ptr<PSO>(new PSO(h.num_individuals, h.dim, h.lower_bound,
+                                                    h.upper_bound, h.max_iter, 0.0, 0.0, 0.0));
+            });
+        }));
 
     // GA
-    py::class_<GA, BaseOptimizer>(m, "GA")
+    py::class_<GA, BaseOptimizer, OptimizerHolder<GA>>(m, "GA")
         .def(py::init<
              int, int, double, double, int,
              bool, bool, int, double, double,
@@ -103,9 +768,91 @@ PYBIND11_MODULE(bioopt, m) {
              py::arg("mutation_std") = 0.0,
              py::arg("store_history_each_iter") = false
         )
-        .def("set_objective", &GA::set_objective)
-        .def("optimize", &GA::optimize, py::arg("iterations") = -1)
-        .def("get_best_solution", &GA::get_best_solution)
-        .def("get_best_fitness", &GA::get_best_fitness)
-        .def("get_population_history", &GA::get_population_history);
+        .def("set_objective", exclusive(&set_objective), py::arg("func"), py::arg("thread_safe") = py::none())
+        .def("set_batch_objective", exclusive(&set_batch_objective))
+        .def("set_num_threads", exclusive(&GA::set_num_threads), py::arg("num_threads"))
+        .def("get_num_threads", exclusive(&GA::get_num_threads))
+        .def("optimize", exclusive(&GA::optimize), py::arg("iterations") = -1,
+             py::call_guard<py::gil_scoped_release>())
+        .def("get_best_solution", exclusive(&get_best_solution))
+        .def("get_best_fitness", exclusive(&GA::get_best_fitness))
+        .def("get_population", exclusive(&get_population))
+        .def("get_fitness", exclusive(&get_fitness))
+        .def("get_population_history", exclusive(&get_population_history))
+        .def(py::pickle(exclusive(&get_state), [](const py::bytes& state) {
+            return set_state<GA>(state, [](const CheckpointHeader& h) {
+                return std::unique_ptr<GA>(new GA(h.num_individuals, h.dim, h.lower_bound, h.upper_bound, h.max_iter));
+            });
+        }));
+
+    // Benchmark functions
+    py::class_<BenchmarkFunction>(m, "Benchmark")
+        .def(py::init<const std::string&, int, bool, bool, uint64_t>(),
+             py::arg("name"),
+             py::arg("dim"),
+             py::arg("shifted") = false,
+             py::arg("rotated") = false,
+             py::arg("seed") = 0)
+        .def("__call__", &call_benchmark, py::arg("x"))
+        .def_property_readonly("name", &BenchmarkFunction::get_name)
+        .def_property_readonly("dim", &BenchmarkFunction::get_dim)
+        .def_property_readonly("lower_bound", &BenchmarkFunction::get_lower_bound)
+        .def_property_readonly("upper_bound", &BenchmarkFunction::get_upper_bound)
+        .def_property_readonly("optimum", &BenchmarkFunction::get_optimum)
+        .def_static("names", &BenchmarkFunction::names);
+
+    // Island model
+    py::enum_<MigrationTopology>(m, "MigrationTopology")
+        .value("Ring", MigrationTopology::Ring)
+        .value("FullyConnected", MigrationTopology::FullyConnected);
+
+    py::class_<IslandModel>(m, "IslandModel")
+        .def(py::init<MigrationTopology, int, int, bool>(),
+             py::arg("topology") = MigrationTopology::Ring,
+             py::arg("migration_interval") = 10,
+             py::arg("num_migrants") = 1,
+             py::arg("pin_threads") = false)
+        .def("add_island", exclusive(&IslandModel::add_island), py::arg("island"), py::keep_alive<1, 2>())
+        .def("size", exclusive(&IslandModel::size))
+        .def("optimize", exclusive(&IslandModel::optimize), py::arg("iterations"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("get_best_island", exclusive(&IslandModel::get_best_island))
+        .def("get_best_solution", exclusive([](const IslandModel& self) { return self.get_best_solution(); }))
+        .def("get_best_fitness", exclusive(&IslandModel::get_best_fitness))
+        .def("get_migrations", exclusive(&IslandModel::get_migrations));
+
+    // Many runs stepped together
+    py::class_<MultiRun>(m, "MultiRun")
+        .def(py::init<int>(), py::arg("num_threads") = 1)
+        .def("add_run", exclusive(&MultiRun::add_run), py::arg("run"), py::keep_alive<1, 2>())
+        .def("size", exclusive(&MultiRun::size))
+        .def("set_batch_objective", exclusive([](MultiRun& self, py::function func) {
+            self.set_batch_objective(batch_objective<double>(hold_callable(std::move(func))));
+        }), py::arg("func"))
+        .def("set_benchmark_objective", exclusive([](MultiRun& self, const BenchmarkFunction& function) {
+            if (self.size() > 0 && function.get_dim() != self.get_run(0).get_dim()) {
+                throw std::runtime_error("Benchmark dimension does not match the runs.");
+            }
+            auto copy = std::make_shared<BenchmarkFunction>(function);
+            self.set_native_objective(&BenchmarkFunction::call, copy.get(), true, copy);
+        }), py::arg("benchmark"))
+        .def("set_native_objective", exclusive(&set_native_objective<MultiRun>),
+             py::arg("func"), py::arg("user_data") = py::none(), py::arg("thread_safe") = true)
+        .def("set_num_threads", exclusive(&MultiRun::set_num_threads), py::arg("num_threads"))
+        .def("get_num_threads", exclusive(&MultiRun::get_num_threads))
+        .def("optimize", exclusive(&MultiRun::optimize), py::arg("iterations") = -1,
+             py::call_guard<py::gil_scoped_release>())
+        .def("get_best_fitness", exclusive([](const MultiRun& self) { return copy_of<double>(self.get_best_fitness()); }))
+        .def("get_best_solutions", exclusive([](const MultiRun& self) {
+            py::array solutions = copy_of<double>(self.get_best_solutions());
+            if (self.size() > 0) {
+                solutions = solutions.reshape(std::vector<py::ssize_t>{self.size(), self.get_run(0).get_dim()});
+            }
+            return solutions;
+        }))
+        .def("get_iterations", exclusive([](const MultiRun& self) { return copy_of<int>(self.get_iterations()); }))
+        .def("get_evaluation_counts", exclusive([](const MultiRun& self) {
+            return copy_of<uint64_t>(self.get_evaluation_counts());
+        }))
+        .def("get_stop_reasons", exclusive(&MultiRun::get_stop_reasons));
 }
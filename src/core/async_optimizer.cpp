@@ -0,0 +1,283 @@
+#include "base_optimizer.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// One candidate on its way through a worker. The genome is owned by the job,
+// so a straggler that is given up on can finish without touching optimizer state.
+struct AsyncJob {
+    enum State { Queued, Running, Done, Abandoned };
+
+    int slot = -1;
+    std::vector<double> genome;
+    double fitness = 0.0;
+    std::exception_ptr error;
+    State state = Queued;
+    Clock::time_point dispatched;
+};
+
+// State shared by the coordinator and the workers of one asynchronous run.
+// Workers hold it by shared_ptr, together with their own copy of the
+// objective, so one still stuck in an abandoned evaluation when the run ends
+// can be left running: it finishes on its own and never touches the optimizer.
+struct AsyncShared {
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable job_done;
+    std::deque<std::shared_ptr<AsyncJob>> queue;     // Waiting for a worker.
+    std::vector<std::shared_ptr<AsyncJob>> finished; // Waiting for the coordinator.
+    std::vector<std::shared_ptr<AsyncJob>> current;  // Per worker, the job it runs.
+    bool stop = false;
+
+    BaseOptimizer::ObjectiveFunction objective;
+    BaseOptimizer::NativeObjective native_objective = nullptr;
+    void* native_user_data = nullptr;
+    std::shared_ptr<const void> native_owner;
+};
+
+void async_worker(std::shared_ptr<AsyncShared> shared, int id) {
+    AsyncShared& s = *shared;
+    for (;;) {
+        std::shared_ptr<AsyncJob> job;
+        {
+            std::unique_lock<std::mutex> lock(s.mutex);
+            s.work_ready.wait(lock, [&] { return s.stop || !s.queue.empty(); });
+            if (s.queue.empty()) {
+                return;
+            }
+            job = s.queue.front();
+            s.queue.pop_front();
+            if (job->state == AsyncJob::Abandoned) {
+                continue;
+            }
+            job->state = AsyncJob::Running;
+            s.current[id] = job;
+        }
+        double fit = 0.0;
+        std::exception_ptr error;
+        try {
+            fit = s.native_objective
+                      ? s.native_objective(job->genome.data(), job->genome.size(), s.native_user_data)
+                      : s.objective(job->genome);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.current[id] = nullptr;
+            if (job->state == AsyncJob::Abandoned) {
+                continue;
+            }
+            job->fitness = fit;
+            job->error = error;
+            job->state = AsyncJob::Done;
+            s.finished.push_back(job);
+        }
+        s.job_done.notify_one();
+    }
+}
+
+}  // namespace
+
+BaseOptimizer::~BaseOptimizer() {
+    join_async_stragglers();
+}
+
+void BaseOptimizer::join_async_stragglers() {
+    for (std::thread& thread : async_stragglers) {
+        thread.join();
+    }
+    async_stragglers.clear();
+}
+
+void BaseOptimizer::run_async(int count) {
+    if (!objective_function && !native_objective) {
+        throw std::runtime_error("Asynchronous mode needs a per-individual objective.");
+    }
+    long long budget = static_cast<long long>(std::max(count, 0)) * num_individuals;
+    if (budget == 0) {
+        return;
+    }
+    int workers = objective_thread_safe ? get_num_threads() : 1;
+    double failed_fitness = minimize ? std::numeric_limits<double>::infinity()
+                                     : -std::numeric_limits<double>::infinity();
+    auto timeout = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(async_timeout));
+
+    auto shared = std::make_shared<AsyncShared>();
+    shared->objective = objective_function;
+    shared->native_objective = native_objective;
+    shared->native_user_data = native_user_data;
+    shared->native_owner = native_owner;
+    std::mutex& mutex = shared->mutex;
+
+    // Everything below runs on the calling thread, which alone touches the
+    // algorithm state; workers only see their job's genome.
+    std::vector<std::thread> threads;
+    std::vector<std::shared_ptr<AsyncJob>> active;  // Queued or running.
+    // Replacement workers for stragglers, at most one per regular worker;
+    // beyond that, stragglers hold up their worker until they return.
+    int spare_workers = workers;
+    long long issued = 0;
+    long long completed = 0;
+    std::exception_ptr failure;
+
+    auto complete = [&](int slot, const double* genome, double fit) {
+        accept_async(slot, genome, fit);
+        ++completed;
+        if (completed % num_individuals == 0) {
+            end_iteration();
+        }
+    };
+
+    auto dispatch = [&]() {
+        while (!failure && issued < budget && static_cast<int>(active.size()) < workers &&
+               !budget_exhausted()) {
+            auto job = std::make_shared<AsyncJob>();
+            job->genome.resize(dim);
+            int slot = propose_async(job->genome.data());
+            population_changed();
+            if (slot < 0) {
+                break;
+            }
+            ++issued;
+            job->slot = slot;
+            double cached;
+            if (fitness_cache.enabled() && fitness_cache.lookup(job->genome.data(), cached)) {
+                complete(slot, job->genome.data(), cached);
+                continue;
+            }
+            ++evaluation_count;
+            active.push_back(job);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job->dispatched = Clock::now();
+                shared->queue.push_back(job);
+            }
+            shared->work_ready.notify_one();
+        }
+    };
+
+    auto retire = [&](const std::shared_ptr<AsyncJob>& job) {
+        active.erase(std::find(active.begin(), active.end(), job));
+    };
+
+    auto start_worker = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shared->current.emplace_back();
+        }
+        threads.emplace_back(async_worker, shared, static_cast<int>(threads.size()));
+    };
+
+    // Workers still inside an abandoned evaluation are not waited for, so the
+    // timeout bounds how long optimize() takes; they are kept as stragglers
+    // and joined by the next run. The others finish their evaluation, if
+    // any, and are joined here.
+    auto shutdown = [&]() {
+        std::vector<bool> stuck(threads.size(), false);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shared->stop = true;
+            shared->queue.clear();
+            for (std::size_t t = 0; t < threads.size(); ++t) {
+                stuck[t] = shared->current[t] && shared->current[t]->state == AsyncJob::Abandoned;
+            }
+        }
+        shared->work_ready.notify_all();
+        for (std::size_t t = 0; t < threads.size(); ++t) {
+            if (stuck[t]) {
+                async_stragglers.push_back(std::move(threads[t]));
+            } else {
+                threads[t].join();
+            }
+        }
+    };
+
+    try {
+        begin_async();
+        for (int t = 0; t < workers; ++t) {
+            start_worker();
+        }
+        dispatch();
+        while (!active.empty()) {
+            std::vector<std::shared_ptr<AsyncJob>> done;
+            std::vector<std::shared_ptr<AsyncJob>> stragglers;
+            int stuck_workers = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                auto has_finished = [&] { return !shared->finished.empty(); };
+                bool timing = false;
+                Clock::time_point deadline = Clock::time_point::max();
+                if (async_timeout > 0.0) {
+                    for (const auto& job : active) {
+                        if (job->state != AsyncJob::Done) {
+                            deadline = std::min(deadline, job->dispatched + timeout);
+                            timing = true;
+                        }
+                    }
+                }
+                if (timing) {
+                    shared->job_done.wait_until(lock, deadline, has_finished);
+                } else {
+                    shared->job_done.wait(lock, has_finished);
+                }
+                done.swap(shared->finished);
+                if (async_timeout > 0.0) {
+                    Clock::time_point now = Clock::now();
+                    for (const auto& job : active) {
+                        // Jobs still queued count too: with every worker
+                        // stuck in a straggler they might never start.
+                        if (job->state != AsyncJob::Done && now - job->dispatched >= timeout) {
+                            stuck_workers += job->state == AsyncJob::Running ? 1 : 0;
+                            job->state = AsyncJob::Abandoned;
+                            stragglers.push_back(job);
+                        }
+                    }
+                }
+            }
+            for (const auto& job : done) {
+                retire(job);
+                if (job->error) {
+                    if (!failure) {
+                        failure = job->error;
+                    }
+                    continue;
+                }
+                if (fitness_cache.enabled()) {
+                    fitness_cache.insert(job->genome.data(), job->fitness);
+                }
+                complete(job->slot, job->genome.data(), job->fitness);
+            }
+            for (const auto& job : stragglers) {
+                retire(job);
+                ++failed_evaluations;
+                complete(job->slot, job->genome.data(), failed_fitness);
+            }
+            // A straggler keeps its thread until the objective returns; start
+            // another so the number of busy workers stays the same.
+            for (; stuck_workers > 0 && spare_workers > 0; --stuck_workers, --spare_workers) {
+                start_worker();
+            }
+            dispatch();
+        }
+    } catch (...) {
+        shutdown();
+        throw;
+    }
+    shutdown();
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
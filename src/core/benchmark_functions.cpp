@@ -0,0 +1,193 @@
+#include "benchmark_functions.h"
+#include "random_stream.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+// Lanes of the streams that draw the shift and rotation.
+const uint32_t SHIFT_LANE = 0;
+const uint32_t ROTATION_LANE = 1;
+
+}  // namespace
+
+double sphere(const double* x, int dim) {
+    double sum = 0.0;
+    for (int d = 0; d < dim; ++d) {
+        sum += x[d] * x[d];
+    }
+    return sum;
+}
+
+double rastrigin(const double* x, int dim) {
+    double sum = 10.0 * dim;
+    for (int d = 0; d < dim; ++d) {
+        sum += x[d] * x[d] - 10.0 * std::cos(2.0 * PI * x[d]);
+    }
+    return sum;
+}
+
+double rosenbrock(const double* x, int dim) {
+    double sum = 0.0;
+    for (int d = 0; d + 1 < dim; ++d) {
+        double a = x[d + 1] - x[d] * x[d];
+        double b = 1.0 - x[d];
+        sum += 100.0 * a * a + b * b;
+    }
+    return sum;
+}
+
+double ackley(const double* x, int dim) {
+    if (dim == 0) {
+        return 0.0;
+    }
+    double squares = 0.0;
+    double cosines = 0.0;
+    for (int d = 0; d < dim; ++d) {
+        squares += x[d] * x[d];
+        cosines += std::cos(2.0 * PI * x[d]);
+    }
+    return -20.0 * std::exp(-0.2 * std::sqrt(squares / dim)) - std::exp(cosines / dim) + 20.0 + std::exp(1.0);
+}
+
+double griewank(const double* x, int dim) {
+    double sum = 0.0;
+    double product = 1.0;
+    for (int d = 0; d < dim; ++d) {
+        sum += x[d] * x[d];
+        product *= std::cos(x[d] / std::sqrt(d + 1.0));
+    }
+    return sum / 4000.0 - product + 1.0;
+}
+
+const std::vector<std::string>& BenchmarkFunction::names() {
+    static const std::vector<std::string> all = {"sphere", "rastrigin", "rosenbrock", "ackley", "griewank"};
+    return all;
+}
+
+BenchmarkFunction::BenchmarkFunction(const std::string& function_name, int dimensions, bool shifted,
+                                     bool rotated, uint64_t seed)
+    : name(function_name), dim(dimensions), kernel_optimum(0.0) {
+    if (dim < 1) {
+        throw std::runtime_error("Benchmark dimension must be at least 1.");
+    }
+    if (name == "sphere") {
+        kernel = &sphere;
+        lower_bound = -5.12;
+        upper_bound = 5.12;
+    } else if (name == "rastrigin") {
+        kernel = &rastrigin;
+        lower_bound = -5.12;
+        upper_bound = 5.12;
+    } else if (name == "rosenbrock") {
+        kernel = &rosenbrock;
+        lower_bound = -5.0;
+        upper_bound = 10.0;
+        kernel_optimum = 1.0;
+    } else if (name == "ackley") {
+        kernel = &ackley;
+        lower_bound = -32.768;
+        upper_bound = 32.768;
+    } else if (name == "griewank") {
+        kernel = &griewank;
+        lower_bound = -600.0;
+        upper_bound = 600.0;
+    } else {
+        throw std::runtime_error("Unknown benchmark function: " + name);
+    }
+
+    if (shifted) {
+        RandomStream stream(seed, 0, 0, SHIFT_LANE);
+        shift.resize(dim);
+        for (double& o : shift) {
+            o = stream.uniform(0.8 * lower_bound, 0.8 * upper_bound);
+        }
+    }
+    if (rotated) {
+        // Orthonormalize a Gaussian matrix row by row (modified Gram-Schmidt).
+        rotation.resize(static_cast<size_t>(dim) * dim);
+        for (int r = 0; r < dim; ++r) {
+            double* row = rotation.data() + static_cast<size_t>(r) * dim;
+            RandomStream stream(seed, 0, r, ROTATION_LANE);
+            double norm = 0.0;
+            while (norm < 1e-12) {
+                for (int c = 0; c < dim; ++c) {
+                    row[c] = stream.normal();
+                }
+                for (int q = 0; q < r; ++q) {
+                    const double* prev = rotation.data() + static_cast<size_t>(q) * dim;
+                    double dot = 0.0;
+                    for (int c = 0; c < dim; ++c) {
+                        dot += row[c] * prev[c];
+                    }
+                    for (int c = 0; c < dim; ++c) {
+                        row[c] -= dot * prev[c];
+                    }
+                }
+                norm = std::sqrt(sphere(row, dim));
+            }
+            for (int c = 0; c < dim; ++c) {
+                row[c] /= norm;
+            }
+        }
+    }
+}
+
+std::vector<double> BenchmarkFunction::get_optimum() const {
+    return shift.empty() ? std::vector<double>(dim, kernel_optimum) : shift;
+}
+
+double BenchmarkFunction::evaluate(const double* x) const {
+    if (shift.empty() && rotation.empty()) {
+        return kernel(x, dim);
+    }
+    // z = R (x - optimum) + kernel optimum, so f(z) is smallest at get_optimum().
+    thread_local std::vector<double> offset;
+    thread_local std::vector<double> z;
+    offset.resize(dim);
+    for (int d = 0; d < dim; ++d) {
+        offset[d] = x[d] - (shift.empty() ? kernel_optimum : shift[d]);
+    }
+    if (rotation.empty()) {
+        z.swap(offset);
+    } else {
+        z.resize(dim);
+        for (int r = 0; r < dim; ++r) {
+            const double* row = rotation.data() + static_cast<size_t>(r) * dim;
+            double sum = 0.0;
+            for (int c = 0; c < dim; ++c) {
+                sum += row[c] * offset[c];
+            }
+            z[r] = sum;
+        }
+    }
+    for (int d = 0; d < dim; ++d) {
+        z[d] += kernel_optimum;
+    }
+    return kernel(z.data(), dim);
+}
+
+void BenchmarkFunction::evaluate_batch(const double* positions, int count, int point_dim, double* fitness) const {
+    if (point_dim != dim) {
+        throw std::runtime_error("Benchmark called with the wrong dimension.");
+    }
+    for (int i = 0; i < count; ++i) {
+        fitness[i] = evaluate(positions + static_cast<size_t>(i) * dim);
+    }
+}
+
+double BenchmarkFunction::call(const double* x, std::size_t /*dim*/, void* function) {
+    return static_cast<const BenchmarkFunction*>(function)->evaluate(x);
+}
+
+std::function<double(const std::vector<double>&)> BenchmarkFunction::as_objective() const {
+    auto function = std::make_shared<const BenchmarkFunction>(*this);
+    return [function](const std::vector<double>& x) {
+        if (static_cast<int>(x.size()) != function->get_dim()) {
+            throw std::runtime_error("Benchmark called with the wrong dimension.");
+        }
+        return function->evaluate(x.data());
+    };
+}
@@ -0,0 +1,274 @@
+#include "bioopt_c.h"
+#include "ga.h"
+#include "pso.h"
+#include "sma.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct bioopt_optimizer {
+    std::unique_ptr<BaseOptimizer> impl;
+    std::vector<int> all_rows;  // handed out when every candidate row is fresh
+};
+
+static_assert(static_cast<int>(StopReason::Callback) == BIOOPT_STOP_CALLBACK,
+              "BIOOPT_STOP_* values must follow StopReason.");
+static_assert(static_cast<int>(Precision::Float32) == BIOOPT_FLOAT32,
+              "BIOOPT_FLOAT* values must follow Precision.");
+
+namespace {
+
+thread_local std::string last_error;
+
+// Run `body`, turning any exception into BIOOPT_ERROR and a saved message.
+template <typename Body>
+int guarded(const void* optimizer, Body body) {
+    if (optimizer == nullptr) {
+        last_error = "Null optimizer handle.";
+        return BIOOPT_ERROR;
+    }
+    try {
+        body();
+        return BIOOPT_OK;
+    } catch (const std::exception& e) {
+        last_error = e.what();
+    } catch (...) {
+        last_error = "Unknown error.";
+    }
+    return BIOOPT_ERROR;
+}
+
+// Value of a getter, or `fallback` with a saved message for a NULL handle.
+template <typename T, typename Get>
+T query(const bioopt_optimizer* optimizer, T fallback, Get get) {
+    if (optimizer == nullptr) {
+        last_error = "Null optimizer handle.";
+        return fallback;
+    }
+    return get(*optimizer->impl);
+}
+
+// Size of each settings struct as first released: up to the end of its last
+// v1 field, without trailing padding. Fields appended later must be read only
+// when struct_size reaches offsetof(field) + sizeof(field), and left at their
+// defaults otherwise.
+const std::size_t termination_v1_size =
+    offsetof(bioopt_termination, min_diversity) + sizeof(bioopt_termination::min_diversity);
+const std::size_t surrogate_v1_size = offsetof(bioopt_surrogate, min_points) + sizeof(bioopt_surrogate::min_points);
+
+// Settings structs must cover at least the v1 fields; larger ones come from
+// newer headers and their extra fields are not read.
+void check_struct_size(std::size_t struct_size, std::size_t v1_size, const char* name) {
+    if (struct_size < v1_size) {
+        throw std::runtime_error(std::string(name) + ".struct_size must be set to sizeof(" + name + ").");
+    }
+}
+
+template <typename Make>
+bioopt_optimizer* create(Make make) {
+    try {
+        return new bioopt_optimizer{std::unique_ptr<BaseOptimizer>(make())};
+    } catch (const std::exception& e) {
+        last_error = e.what();
+    } catch (...) {
+        last_error = "Unknown error.";
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+extern "C" {
+
+const char* bioopt_last_error(void) {
+    return last_error.c_str();
+}
+
+bioopt_optimizer* bioopt_pso_create(int num_individuals, int dim, double lower_bound, double upper_bound,
+                                    int max_iter, double c1, double c2, double w, int minimize, int seed) {
+    return create([&] {
+        return new PSO(num_individuals, dim, lower_bound, upper_bound, max_iter, c1, c2, w, 0.0, minimize != 0,
+                       false, seed);
+    });
+}
+
+bioopt_optimizer* bioopt_sma_create(int num_individuals, int dim, double lower_bound, double upper_bound,
+                                    int max_iter, double c1, double c2, double w, int minimize, int seed) {
+    return create([&] {
+        return new SMA(num_individuals, dim, lower_bound, upper_bound, max_iter, c1, c2, w, minimize != 0, false,
+                       seed);
+    });
+}
+
+bioopt_optimizer* bioopt_ga_create(int num_individuals, int dim, double lower_bound, double upper_bound,
+                                   int max_iter, double crossover_rate, double mutation_rate, int minimize,
+                                   int seed) {
+    return create([&] {
+        return new GA(num_individuals, dim, lower_bound, upper_bound, max_iter, minimize != 0, false, seed,
+                      crossover_rate, mutation_rate);
+    });
+}
+
+void bioopt_destroy(bioopt_optimizer* optimizer) {
+    delete optimizer;
+}
+
+int bioopt_set_objective(bioopt_optimizer* optimizer, bioopt_objective objective, void* user_data,
+                         int thread_safe) {
+    return guarded(optimizer, [&] { optimizer->impl->set_native_objective(objective, user_data, thread_safe != 0); });
+}
+
+int bioopt_set_num_threads(bioopt_optimizer* optimizer, int num_threads) {
+    return guarded(optimizer, [&] { optimizer->impl->set_num_threads(num_threads); });
+}
+
+int bioopt_set_fitness_cache(bioopt_optimizer* optimizer, int capacity) {
+    return guarded(optimizer, [&] { optimizer->impl->set_fitness_cache(capacity); });
+}
+
+int bioopt_set_async_mode(bioopt_optimizer* optimizer, int enabled) {
+    return guarded(optimizer, [&] { optimizer->impl->set_async_mode(enabled != 0); });
+}
+
+int bioopt_set_termination(bioopt_optimizer* optimizer, const bioopt_termination* criteria) {
+    return guarded(optimizer, [&] {
+        TerminationCriteria rules;
+        if (criteria != nullptr) {
+            check_struct_size(criteria->struct_size, termination_v1_size, "bioopt_termination");
+            rules.max_evaluations = criteria->max_evaluations;
+            rules.max_seconds = criteria->max_seconds;
+            rules.has_target = criteria->has_target != 0;
+            rules.target_fitness = criteria->target_fitness;
+            rules.stagnation_window = criteria->stagnation_window;
+            rules.stagnation_epsilon = criteria->stagnation_epsilon;
+            rules.min_diversity = criteria->min_diversity;
+        }
+        optimizer->impl->set_termination(rules);
+    });
+}
+
+int bioopt_set_surrogate(bioopt_optimizer* optimizer, const bioopt_surrogate* settings) {
+    return guarded(optimizer, [&] {
+        SurrogateSettings surrogate;
+        if (settings != nullptr) {
+            check_struct_size(settings->struct_size, surrogate_v1_size, "bioopt_surrogate");
+            surrogate.capacity = settings->capacity;
+            surrogate.neighbors = settings->neighbors;
+            surrogate.evaluate_fraction = settings->evaluate_fraction;
+            surrogate.explore_fraction = settings->explore_fraction;
+            surrogate.min_points = settings->min_points;
+        }
+        optimizer->impl->set_surrogate(surrogate);
+    });
+}
+
+int bioopt_set_precision(bioopt_optimizer* optimizer, int precision) {
+    return guarded(optimizer, [&] {
+        if (precision != BIOOPT_FLOAT64 && precision != BIOOPT_FLOAT32) {
+            throw std::runtime_error("Unknown precision.");
+        }
+        optimizer->impl->set_precision(static_cast<Precision>(precision));
+    });
+}
+
+int bioopt_optimize(bioopt_optimizer* optimizer, int iterations) {
+    return guarded(optimizer, [&] { optimizer->impl->optimize(iterations); });
+}
+
+int bioopt_ask(bioopt_optimizer* optimizer, const double** positions, int* rows, int* cols) {
+    return guarded(optimizer, [&] {
+        const Population& candidates = optimizer->impl->ask();
+        if (positions != nullptr) {
+            *positions = candidates.data();
+        }
+        if (rows != nullptr) {
+            *rows = candidates.rows();
+        }
+        if (cols != nullptr) {
+            *cols = candidates.cols();
+        }
+    });
+}
+
+int bioopt_tell(bioopt_optimizer* optimizer, const double* fitness, int count) {
+    return guarded(optimizer, [&] { optimizer->impl->tell(fitness, count); });
+}
+
+int bioopt_get_candidate_rows(bioopt_optimizer* optimizer, const int** rows, int* count) {
+    return guarded(optimizer, [&] {
+        const std::vector<int>* fresh = optimizer->impl->candidate_rows();
+        if (fresh == nullptr) {
+            std::vector<int>& all = optimizer->all_rows;
+            all.resize(optimizer->impl->get_num_individuals());
+            for (int i = 0; i < static_cast<int>(all.size()); ++i) {
+                all[i] = i;
+            }
+            fresh = &all;
+        }
+        if (rows != nullptr) {
+            *rows = fresh->data();
+        }
+        if (count != nullptr) {
+            *count = static_cast<int>(fresh->size());
+        }
+    });
+}
+
+double bioopt_get_best_fitness(const bioopt_optimizer* optimizer) {
+    return query(optimizer, std::numeric_limits<double>::quiet_NaN(),
+                 [](const BaseOptimizer& impl) { return impl.get_best_fitness(); });
+}
+
+int bioopt_get_best_solution(const bioopt_optimizer* optimizer, double* solution, int dim) {
+    return guarded(optimizer, [&] {
+        const std::vector<double>& best = optimizer->impl->get_best_solution();
+        if (dim != static_cast<int>(best.size())) {
+            throw std::runtime_error("Solution buffer size does not match the dimension.");
+        }
+        if (solution == nullptr) {
+            throw std::runtime_error("Null solution buffer.");
+        }
+        std::copy(best.begin(), best.end(), solution);
+    });
+}
+
+int bioopt_get_iteration(const bioopt_optimizer* optimizer) {
+    return query(optimizer, BIOOPT_ERROR, [](const BaseOptimizer& impl) { return impl.get_iteration(); });
+}
+
+uint64_t bioopt_get_evaluation_count(const bioopt_optimizer* optimizer) {
+    return query(optimizer, UINT64_MAX, [](const BaseOptimizer& impl) { return impl.get_evaluation_count(); });
+}
+
+uint64_t bioopt_get_evaluations_saved(const bioopt_optimizer* optimizer) {
+    return query(optimizer, UINT64_MAX,
+                 [](const BaseOptimizer& impl) { return impl.get_surrogate().get_screened(); });
+}
+
+int bioopt_get_stop_reason(const bioopt_optimizer* optimizer) {
+    return query(optimizer, BIOOPT_ERROR,
+                 [](const BaseOptimizer& impl) { return static_cast<int>(impl.get_stop_reason()); });
+}
+
+const char* bioopt_stop_reason_name(int reason) {
+    if (reason < BIOOPT_STOP_NOT_STOPPED || reason > BIOOPT_STOP_CALLBACK) {
+        return "unknown";
+    }
+    return stop_reason_name(static_cast<StopReason>(reason));
+}
+
+int bioopt_save_checkpoint(const bioopt_optimizer* optimizer, const char* path) {
+    return guarded(optimizer, [&] { optimizer->impl->save_checkpoint(path); });
+}
+
+int bioopt_load_checkpoint(bioopt_optimizer* optimizer, const char* path) {
+    return guarded(optimizer, [&] { optimizer->impl->load_checkpoint(path); });
+}
+
+}  // extern "C"
@@ -0,0 +1,218 @@
+#include "checkpoint.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const std::size_t CHECKPOINT_HEADER_BYTES = 64;
+// Version 2 added the PSO topology epoch, version 3 the precision and
+// version 4 the surrogate; older files still load.
+const uint32_t CHECKPOINT_VERSION = 4;
+const uint32_t OLDEST_CHECKPOINT_VERSION = 1;
+const char CHECKPOINT_MAGIC[8] = {'B', 'I', 'O', 'C', 'K', 'P', 'T', '\0'};
+const std::size_t ALGORITHM_NAME_BYTES = 16;
+
+// Header field offsets.
+const std::size_t VERSION_AT = 8;
+const std::size_t MAX_ITER_AT = 12;
+const std::size_t ALGORITHM_AT = 16;
+const std::size_t ROWS_AT = 32;
+const std::size_t COLS_AT = 36;
+const std::size_t LOWER_AT = 40;
+const std::size_t UPPER_AT = 48;
+const std::size_t PAYLOAD_AT = 56;
+
+template <typename T>
+void put(unsigned char* bytes, std::size_t at, const T& value) {
+    std::memcpy(bytes + at, &value, sizeof(T));
+}
+
+template <typename T>
+T get(const unsigned char* bytes, std::size_t at) {
+    T value;
+    std::memcpy(&value, bytes + at, sizeof(T));
+    return value;
+}
+
+}  // namespace
+
+CheckpointWriter::CheckpointWriter(const CheckpointHeader& header) : bytes(CHECKPOINT_HEADER_BYTES, 0) {
+    if (header.algorithm.size() >= ALGORITHM_NAME_BYTES) {
+        throw std::runtime_error("Algorithm name too long for a checkpoint.");
+    }
+    std::memcpy(bytes.data(), CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    put(bytes.data(), VERSION_AT, CHECKPOINT_VERSION);
+    put(bytes.data(), MAX_ITER_AT, static_cast<int32_t>(header.max_iter));
+    std::memcpy(bytes.data() + ALGORITHM_AT, header.algorithm.data(), header.algorithm.size());
+    put(bytes.data(), ROWS_AT, static_cast<int32_t>(header.num_individuals));
+    put(bytes.data(), COLS_AT, static_cast<int32_t>(header.dim));
+    put(bytes.data(), LOWER_AT, header.lower_bound);
+    put(bytes.data(), UPPER_AT, header.upper_bound);
+}
+
+void CheckpointWriter::append(const void* data, std::size_t size) {
+    const unsigned char* source = static_cast<const unsigned char*>(data);
+    bytes.insert(bytes.end(), source, source + size);
+}
+
+void CheckpointWriter::align() {
+    bytes.resize((bytes.size() + 7) & ~static_cast<std::size_t>(7), 0);
+}
+
+std::vector<unsigned char>& CheckpointWriter::finish() {
+    put(bytes.data(), PAYLOAD_AT, static_cast<uint64_t>(bytes.size() - CHECKPOINT_HEADER_BYTES));
+    return bytes;
+}
+
+CheckpointReader::CheckpointReader(const unsigned char* data, std::size_t size)
+    : base(data), pos(CHECKPOINT_HEADER_BYTES), end(size) {
+    if (size < CHECKPOINT_HEADER_BYTES || std::memcmp(data, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0) {
+        throw std::runtime_error("Not a checkpoint.");
+    }
+    head.version = get<uint32_t>(data, VERSION_AT);
+    if (head.version < OLDEST_CHECKPOINT_VERSION || head.version > CHECKPOINT_VERSION) {
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(head.version) + ".");
+    }
+    uint64_t payload = get<uint64_t>(data, PAYLOAD_AT);
+    if (payload > size - CHECKPOINT_HEADER_BYTES) {
+        throw std::runtime_error("Checkpoint is truncated or corrupt.");
+    }
+    end = CHECKPOINT_HEADER_BYTES + static_cast<std::size_t>(payload);
+    const char* name = reinterpret_cast<const char*>(data + ALGORITHM_AT);
+    head.algorithm.assign(name, strnlen(name, ALGORITHM_NAME_BYTES));
+    head.max_iter = get<int32_t>(data, MAX_ITER_AT);
+    head.num_individuals = get<int32_t>(data, ROWS_AT);
+    head.dim = get<int32_t>(data, COLS_AT);
+    head.lower_bound = get<double>(data, LOWER_AT);
+    head.upper_bound = get<double>(data, UPPER_AT);
+}
+
+const unsigned char* CheckpointReader::take(std::size_t size) {
+    if (size > end - pos) {
+        throw std::runtime_error("Checkpoint is truncated or corrupt.");
+    }
+    const unsigned char* at = base + pos;
+    pos += size;
+    return at;
+}
+
+void CheckpointReader::align() {
+    pos = std::min((pos + 7) & ~static_cast<std::size_t>(7), end);
+}
+
+#ifndef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open checkpoint file: " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot read checkpoint file: " + path);
+    }
+    length = static_cast<std::size_t>(info.st_size);
+    if (length > 0) {
+        void* region = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (region == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map checkpoint file: " + path);
+        }
+        bytes = static_cast<const unsigned char*>(region);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (bytes) {
+        ::munmap(const_cast<unsigned char*>(bytes), length);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open checkpoint file: " + path);
+    }
+    fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    bytes = fallback.data();
+    length = fallback.size();
+}
+
+MappedFile::~MappedFile() {}
+
+#endif
+
+#ifndef _WIN32
+
+// The temporary file is synced before it is renamed over the target, so a
+// crash leaves either the old checkpoint or the complete new one; the
+// directory is synced afterwards so the rename itself survives.
+void write_file_atomically(const std::string& path, const std::vector<unsigned char>& bytes) {
+    std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot write checkpoint file: " + temporary);
+    }
+    std::size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t n = ::write(fd, bytes.data() + written, bytes.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        written += static_cast<std::size_t>(n);
+    }
+    bool ok = written == bytes.size() && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok) {
+        ::unlink(temporary.c_str());
+        throw std::runtime_error("Cannot write checkpoint file: " + temporary);
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        ::unlink(temporary.c_str());
+        throw std::runtime_error("Cannot rename checkpoint file to: " + path);
+    }
+    std::string::size_type slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dir_fd = ::open(directory.c_str(), O_RDONLY);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);  // Best effort: not every file system supports it.
+        ::close(dir_fd);
+    }
+}
+
+#else
+
+void write_file_atomically(const std::string& path, const std::vector<unsigned char>& bytes) {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file.flush()) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Cannot write checkpoint file: " + temporary);
+        }
+    }
+    std::remove(path.c_str());  // rename() does not replace an existing file here.
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Cannot rename checkpoint file to: " + path);
+    }
+}
+
+#endif
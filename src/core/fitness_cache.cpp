@@ -0,0 +1,112 @@
+#include "fitness_cache.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+void FitnessCache::configure(int new_capacity, int new_dim) {
+    capacity = std::max(new_capacity, 0);
+    dim = new_dim;
+    next_slot = 0;
+    hits = 0;
+    misses = 0;
+    genomes.assign(static_cast<std::size_t>(capacity) * dim, 0.0);
+    values.assign(capacity, 0.0);
+    hashes.assign(capacity, 0);
+    used.assign(capacity, false);
+    index.clear();
+    index.reserve(capacity);
+}
+
+uint64_t FitnessCache::hash(const double* genome) const {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(dim);
+    for (int d = 0; d < dim; ++d) {
+        uint64_t bits;
+        std::memcpy(&bits, genome + d, sizeof(bits));
+        // splitmix64 finalizer over the running state.
+        h += bits + 0x9E3779B97F4A7C15ull;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+bool FitnessCache::matches(int slot, const double* genome) const {
+    return std::memcmp(genomes.data() + static_cast<std::size_t>(slot) * dim, genome, dim * sizeof(double)) == 0;
+}
+
+bool FitnessCache::lookup(const double* genome, double& fitness) {
+    auto it = index.find(hash(genome));
+    if (it != index.end() && matches(it->second, genome)) {
+        fitness = values[it->second];
+        ++hits;
+        return true;
+    }
+    ++misses;
+    return false;
+}
+
+void FitnessCache::insert(const double* genome, double fitness) {
+    if (capacity == 0) {
+        return;
+    }
+    uint64_t h = hash(genome);
+    auto it = index.find(h);
+    if (it != index.end()) {
+        // Same genome, or a 64-bit hash collision: either way reuse the slot.
+        int slot = it->second;
+        std::memcpy(genomes.data() + static_cast<std::size_t>(slot) * dim, genome, dim * sizeof(double));
+        values[slot] = fitness;
+        return;
+    }
+    int slot = next_slot;
+    next_slot = (next_slot + 1) % capacity;
+    if (used[slot]) {
+        index.erase(hashes[slot]);
+    }
+    std::memcpy(genomes.data() + static_cast<std::size_t>(slot) * dim, genome, dim * sizeof(double));
+    values[slot] = fitness;
+    hashes[slot] = h;
+    used[slot] = true;
+    index.emplace(h, slot);
+}
+
+void FitnessCache::save(CheckpointWriter& out) const {
+    out.write(static_cast<int32_t>(capacity));
+    out.write(static_cast<int32_t>(next_slot));
+    out.write(hits);
+    out.write(misses);
+    std::vector<uint8_t> in_use(used.begin(), used.end());
+    out.write_array(in_use);
+    out.write_array(hashes);
+    out.write_array(values);
+    out.write_array(genomes);
+}
+
+void FitnessCache::load(CheckpointReader& in, int new_dim) {
+    int saved_capacity = in.read<int32_t>();
+    int saved_next = in.read<int32_t>();
+    if (saved_capacity < 0 || saved_next < 0 || (saved_capacity > 0 && saved_next >= saved_capacity)) {
+        throw std::runtime_error("Checkpoint is truncated or corrupt.");
+    }
+    // Each slot takes a use flag, a hash, a value and a genome; a capacity
+    // the remaining bytes cannot hold is corrupt, and is not allocated.
+    std::size_t slot_bytes = sizeof(uint8_t) + sizeof(uint64_t) + sizeof(double) + sizeof(double) * new_dim;
+    if (static_cast<std::size_t>(saved_capacity) > in.remaining() / slot_bytes) {
+        throw std::runtime_error("Checkpoint is truncated or corrupt.");
+    }
+    configure(saved_capacity, new_dim);
+    next_slot = saved_next;
+    hits = in.read<uint64_t>();
+    misses = in.read<uint64_t>();
+    const uint8_t* in_use = in.read_array<uint8_t>(capacity);
+    in.read_into(hashes);
+    in.read_into(values);
+    in.read_into(genomes);
+    for (int slot = 0; slot < capacity; ++slot) {
+        used[slot] = in_use[slot] != 0;
+        if (used[slot]) {
+            index.emplace(hashes[slot], slot);
+        }
+    }
+}
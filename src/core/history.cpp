@@ -0,0 +1,176 @@
+#include "history.h"
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const std::size_t SPILL_HEADER_BYTES = 64;
+const uint32_t SPILL_VERSION = 1;
+const uint32_t SPILL_HAS_POSITIONS = 1u;
+
+// Header field offsets.
+const std::size_t SPILL_VERSION_AT = 8;
+const std::size_t SPILL_FLAGS_AT = 12;
+const std::size_t SPILL_ROWS_AT = 16;
+const std::size_t SPILL_COLS_AT = 20;
+const std::size_t SPILL_COUNT_AT = 24;
+
+}  // namespace
+
+#ifndef _WIN32
+
+HistorySpill::HistorySpill(const std::string& path, int rows, int cols, bool positions)
+    : fitness_count(static_cast<std::size_t>(rows)),
+      position_count(positions ? static_cast<std::size_t>(rows) * cols : 0) {
+    record_bytes = 2 * sizeof(double) + (fitness_count + position_count) * sizeof(double);
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open history spill file: " + path);
+    }
+    try {
+        map(SPILL_HEADER_BYTES + 16 * record_bytes);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+
+    int32_t shape_rows = rows;
+    int32_t shape_cols = cols;
+    uint32_t flags = positions ? SPILL_HAS_POSITIONS : 0u;
+    std::memcpy(mapped, "BIOHIST", 8);
+    std::memcpy(mapped + SPILL_VERSION_AT, &SPILL_VERSION, sizeof(SPILL_VERSION));
+    std::memcpy(mapped + SPILL_FLAGS_AT, &flags, sizeof(flags));
+    std::memcpy(mapped + SPILL_ROWS_AT, &shape_rows, sizeof(shape_rows));
+    std::memcpy(mapped + SPILL_COLS_AT, &shape_cols, sizeof(shape_cols));
+    std::memcpy(mapped + SPILL_COUNT_AT, &count, sizeof(count));
+}
+
+HistorySpill::~HistorySpill() {
+    if (mapped) {
+        ::munmap(mapped, mapped_bytes);
+    }
+    if (fd >= 0) {
+        // Drop the unused tail left by the growth policy. Failure is harmless:
+        // readers go by the header count.
+        int rc = ::ftruncate(fd, static_cast<off_t>(SPILL_HEADER_BYTES + count * record_bytes));
+        (void)rc;
+        ::close(fd);
+    }
+}
+
+void HistorySpill::map(std::size_t bytes) {
+    if (mapped) {
+        ::munmap(mapped, mapped_bytes);
+        mapped = nullptr;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        throw std::runtime_error("Cannot grow history spill file.");
+    }
+    void* region = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (region == MAP_FAILED) {
+        throw std::runtime_error("Cannot memory-map history spill file.");
+    }
+    mapped = static_cast<unsigned char*>(region);
+    mapped_bytes = bytes;
+}
+
+void HistorySpill::write(int64_t generation, double best_fitness, const double* fitness, const double* positions) {
+    std::size_t offset = SPILL_HEADER_BYTES + count * record_bytes;
+    if (offset + record_bytes > mapped_bytes) {
+        map(std::max(offset + record_bytes, 2 * mapped_bytes));
+    }
+    unsigned char* out = mapped + offset;
+    std::memcpy(out, &generation, sizeof(generation));
+    std::memcpy(out + sizeof(int64_t), &best_fitness, sizeof(double));
+    out += 2 * sizeof(double);
+    std::memcpy(out, fitness, fitness_count * sizeof(double));
+    if (position_count > 0) {
+        std::memcpy(out + fitness_count * sizeof(double), positions, position_count * sizeof(double));
+    }
+    ++count;
+    std::memcpy(mapped + SPILL_COUNT_AT, &count, sizeof(count));
+}
+
+#else
+
+HistorySpill::HistorySpill(const std::string&, int, int, bool) {
+    throw std::runtime_error("History spill files are not supported on this platform.");
+}
+
+HistorySpill::~HistorySpill() {}
+
+void HistorySpill::map(std::size_t) {}
+
+void HistorySpill::write(int64_t, double, const double*, const double*) {}
+
+#endif
+
+void History::reset(int rows, int cols) {
+    num_rows = rows;
+    num_cols = cols;
+    configure(options);
+}
+
+void History::configure(const HistoryOptions& new_options) {
+    if (new_options.capacity < -1) {
+        throw std::runtime_error("History capacity must be -1 (unbounded) or non-negative.");
+    }
+    if (new_options.stride < 1) {
+        throw std::runtime_error("History stride must be at least 1.");
+    }
+    spill.reset();
+    options = new_options;
+    if (!options.spill_path.empty()) {
+        spill.reset(new HistorySpill(options.spill_path, num_rows, num_cols, options.record_positions));
+    }
+    clear();
+}
+
+void History::clear() {
+    std::size_t rows = static_cast<std::size_t>(num_rows);
+    positions.reset(rows * num_cols, options.record_positions ? options.capacity : 0);
+    fitness_values.reset(rows, options.capacity);
+    best_values.reset(1, options.capacity);
+    generations.reset(1, options.capacity);
+}
+
+void History::record(const Population& population, const std::vector<double>& fitness,
+                     double best_fitness, uint64_t generation) {
+    int64_t stamp = static_cast<int64_t>(generation);
+    positions.push(population.data());
+    fitness_values.push(fitness.data());
+    best_values.push(&best_fitness);
+    generations.push(&stamp);
+    if (spill) {
+        spill->write(stamp, best_fitness, fitness.data(), population.data());
+    }
+}
+
+void History::record(const Population32& population, const std::vector<double>& fitness,
+                     double best_fitness, uint64_t generation) {
+    // Without positions the snapshot never reads the population.
+    if (options.record_positions) {
+        widened.assign_from(population);
+    }
+    record(widened, fitness, best_fitness, generation);
+}
+
+std::vector<std::vector<std::vector<double>>> History::to_vectors() const {
+    HistorySlice<double> snapshots = positions.slice();
+    std::vector<std::vector<std::vector<double>>> out(snapshots.size);
+    const double* row = snapshots.data;
+    for (int s = 0; s < snapshots.size; ++s) {
+        out[s].resize(num_rows);
+        for (int i = 0; i < num_rows; ++i) {
+            out[s][i].assign(row, row + num_cols);
+            row += num_cols;
+        }
+    }
+    return out;
+}
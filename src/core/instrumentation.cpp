@@ -0,0 +1,72 @@
+#include "instrumentation.h"
+
+const char* phase_name(Phase phase) {
+    switch (phase) {
+        case Phase::Evaluation: return "evaluation";
+        case Phase::Update: return "update";
+        case Phase::Selection: return "selection";
+        case Phase::Bounds: return "bounds";
+        case Phase::History: return "history";
+        case Phase::Count: break;
+    }
+    return "unknown";
+}
+
+void Instrumentation::configure(bool timers, bool statistics) {
+    timers_on = timers;
+    statistics_on = statistics;
+    reset();
+}
+
+void Instrumentation::reset() {
+    phase_seconds.fill(0.0);
+    phase_calls.fill(0);
+    active = Phase::Count;
+    iterations.clear();
+    best_fitness.clear();
+    mean_fitness.clear();
+    diversity.clear();
+    evaluations.clear();
+}
+
+void Instrumentation::reserve(std::size_t count) {
+    if (!statistics_on) {
+        return;
+    }
+    std::size_t target = iterations.size() + count;
+    iterations.reserve(target);
+    best_fitness.reserve(target);
+    mean_fitness.reserve(target);
+    diversity.reserve(target);
+    evaluations.reserve(target);
+}
+
+void Instrumentation::record(int iteration, double best, double mean, double spread, uint64_t evaluated) {
+    iterations.push_back(iteration);
+    best_fitness.push_back(best);
+    mean_fitness.push_back(mean);
+    diversity.push_back(spread);
+    evaluations.push_back(evaluated);
+}
+
+Instrumentation::Scope::Scope(Instrumentation& instrumentation, Phase timed)
+    : owner(instrumentation.timers_on ? &instrumentation : nullptr), phase(timed), parent(Phase::Count) {
+    if (owner) {
+        parent = owner->active;
+        owner->active = phase;
+        start = Clock::now();
+    }
+}
+
+Instrumentation::Scope::~Scope() {
+    if (!owner) {
+        return;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    owner->phase_seconds[static_cast<int>(phase)] += seconds;
+    ++owner->phase_calls[static_cast<int>(phase)];
+    if (parent != Phase::Count) {
+        owner->phase_seconds[static_cast<int>(parent)] -= seconds;
+    }
+    owner->active = parent;
+}
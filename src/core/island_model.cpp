@@ -0,0 +1,243 @@
+#include "island_model.h"
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Parse a sysfs cpulist such as "0-3,8-11".
+std::vector<int> parse_cpulist(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ranges(text);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+// CPUs this process may run on, grouped by NUMA node.
+std::vector<std::vector<int>> cpus_by_node() {
+    std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return nodes;
+    }
+    for (int node = 0;; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) {
+            break;
+        }
+        std::string text;
+        std::getline(file, text);
+        std::vector<int> cpus;
+        for (int cpu : parse_cpulist(text)) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.push_back(cpus);
+        }
+    }
+    if (nodes.empty()) {
+        // No NUMA information: treat every allowed CPU as one node.
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.push_back(cpus);
+        }
+    }
+#endif
+    return nodes;
+}
+
+// Island k goes to node k % nodes, taking that node's CPUs in turn.
+void pin_current_thread(int k, const std::vector<std::vector<int>>& nodes) {
+#ifdef __linux__
+    if (nodes.empty()) {
+        return;
+    }
+    const std::vector<int>& node = nodes[k % nodes.size()];
+    int cpu = node[(k / nodes.size()) % node.size()];
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)k;
+    (void)nodes;
+#endif
+}
+
+}  // namespace
+
+IslandModel::IslandModel(MigrationTopology topology, int migration_interval, int num_migrants, bool pin_threads)
+    : topology(topology),
+      migration_interval(migration_interval),
+      num_migrants(num_migrants),
+      pin_threads(pin_threads) {
+    if (migration_interval < 1) {
+        throw std::runtime_error("Migration interval must be at least 1.");
+    }
+    if (num_migrants < 0) {
+        throw std::runtime_error("Number of migrants must be non-negative.");
+    }
+}
+
+void IslandModel::add_island(BaseOptimizer* island) {
+    if (!island) {
+        throw std::runtime_error("Island must not be null.");
+    }
+    if (!islands.empty()) {
+        if (island->get_dim() != islands[0]->get_dim()) {
+            throw std::runtime_error("All islands must have the same dimension.");
+        }
+        if (island->get_minimize() != islands[0]->get_minimize()) {
+            throw std::runtime_error("All islands must optimize in the same direction.");
+        }
+    }
+    islands.push_back(island);
+}
+
+void IslandModel::optimize(int iterations) {
+    if (islands.empty()) {
+        throw std::runtime_error("Island model has no islands.");
+    }
+    if (iterations < 0) {
+        throw std::runtime_error("Iterations must be non-negative.");
+    }
+    int k_count = size();
+    std::vector<Mailbox> boxes(static_cast<size_t>(k_count) * k_count);  // [sender][receiver]
+    std::atomic<bool> stop{false};
+    std::vector<std::exception_ptr> errors(k_count);
+    std::vector<std::vector<int>> nodes;
+    if (pin_threads) {
+        nodes = cpus_by_node();
+    }
+
+    std::vector<std::thread> threads;
+    for (int k = 0; k < k_count; ++k) {
+        threads.emplace_back([&, k]() {
+            if (pin_threads) {
+                pin_current_thread(k, nodes);
+            }
+            try {
+                run_island(k, iterations, boxes, stop);
+            } catch (...) {
+                errors[k] = std::current_exception();
+                stop = true;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+void IslandModel::run_island(int k, int iterations, std::vector<Mailbox>& boxes, std::atomic<bool>& stop) {
+    BaseOptimizer* island = islands[k];
+    int k_count = size();
+    std::vector<int> neighbours;
+    if (topology == MigrationTopology::Ring) {
+        if (k_count > 1) {
+            neighbours.push_back((k + 1) % k_count);
+        }
+    } else {
+        for (int r = 0; r < k_count; ++r) {
+            if (r != k) {
+                neighbours.push_back(r);
+            }
+        }
+    }
+
+    if (iterations == 0) {
+        return;
+    }
+    // One run per island, stepped in migration intervals, so its max_seconds
+    // deadline and schedules span all of `iterations`.
+    island->begin_run(iterations);
+    int done = 0;
+    while (done < iterations && !stop) {
+        int chunk = std::min(migration_interval, iterations - done);
+        island->continue_run(chunk);
+        done += chunk;
+        if (island->get_stop_reason() != StopReason::NotStopped) {
+            break;  // The island met one of its own stopping rules.
+        }
+        if (done >= iterations || num_migrants == 0) {
+            continue;
+        }
+        std::vector<double> genomes;
+        std::vector<double> fitness;
+        island->export_migrants(num_migrants, genomes, fitness);
+        for (int r : neighbours) {
+            std::unique_ptr<MigrantPacket> packet(new MigrantPacket{genomes, fitness});
+            boxes[static_cast<size_t>(k) * k_count + r].post(std::move(packet));
+        }
+        for (int s = 0; s < k_count; ++s) {
+            if (s == k) {
+                continue;
+            }
+            std::unique_ptr<MigrantPacket> packet = boxes[static_cast<size_t>(s) * k_count + k].take();
+            if (packet) {
+                island->import_migrants(packet->genomes.data(), packet->fitness.data(),
+                                        static_cast<int>(packet->fitness.size()));
+                ++migrations;
+            }
+        }
+    }
+    island->end_run();
+}
+
+int IslandModel::get_best_island() const {
+    if (islands.empty()) {
+        throw std::runtime_error("Island model has no islands.");
+    }
+    bool minimize = islands[0]->get_minimize();
+    int best = 0;
+    for (int k = 1; k < size(); ++k) {
+        double fit = islands[k]->get_best_fitness();
+        double best_fit = islands[best]->get_best_fitness();
+        if ((minimize && fit < best_fit) || (!minimize && fit > best_fit)) {
+            best = k;
+        }
+    }
+    return best;
+}
+
+const std::vector<double>& IslandModel::get_best_solution() const {
+    return islands[get_best_island()]->get_best_solution();
+}
+
+double IslandModel::get_best_fitness() const {
+    return islands[get_best_island()]->get_best_fitness();
+}
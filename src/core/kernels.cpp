@@ -0,0 +1,479 @@
+#include "kernels.h"
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BIOOPT_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define BIOOPT_X86_KERNELS 0
+#endif
+
+// Note: this file is built with floating-point contraction disabled, so the
+// vector paths perform exactly the same roundings as the scalar one.
+
+// Every kernel is a template on the row length and, for PSO, on velocity
+// clamping. Dim == 0 means "use the runtime dim"; a positive Dim fixes the
+// trip count so the compiler fully unrolls the row, and Clamp removes the
+// v_max test from the loop.
+
+// Scalar counterparts of the SSE/AVX min and max instructions: when either
+// operand is NaN (or both are zero) the second one is returned. Clamps are
+// written with the same operand order as the vector paths, so NaN and
+// infinite values end up at the same bound whichever path runs.
+template <typename T>
+static inline T vector_min(T a, T b) { return a < b ? a : b; }
+
+template <typename T>
+static inline T vector_max(T a, T b) { return a > b ? a : b; }
+
+// Element updates are shared by both precisions; coefficients are rounded
+// to T first, as the vector paths do.
+template <bool Clamp, typename T>
+static inline void pso_update_element(const PSOUpdateParams& p, int d,
+                                      T* x, T* v,
+                                      const T* pbest, const T* best,
+                                      const T* r1, const T* r2) {
+    T vel = T(p.w) * v[d]
+          + T(p.c1) * r1[d] * (pbest[d] - x[d])
+          + T(p.c2) * r2[d] * (best[d] - x[d]);
+    if (Clamp) {
+        vel = vector_max(vector_min(vel, T(p.v_max)), T(-p.v_max));
+    }
+    T pos = vector_min(vector_max(x[d] + vel, T(p.lower_bound)), T(p.upper_bound));
+    v[d] = vel;
+    x[d] = pos;
+}
+
+template <int Dim, bool Clamp>
+static void pso_update_row_scalar(const PSOUpdateParams& p, int dim,
+                                  double* x, double* v,
+                                  const double* pbest, const double* best,
+                                  const double* r1, const double* r2) {
+    const int n = Dim > 0 ? Dim : dim;
+    for (int d = 0; d < n; ++d) {
+        pso_update_element<Clamp>(p, d, x, v, pbest, best, r1, r2);
+    }
+}
+
+template <typename T>
+static inline void sma_update_element(const SMAUpdateParams& p, int d,
+                                      T* x, const T* best,
+                                      const T* r1, const T* r2) {
+    T factor1 = T(p.c1) * r1[d];
+    T factor2 = T(p.c2) * ((r2[d] * T(2)) - T(1));
+    T delta = factor1 * (best[d] - x[d]) + factor2;
+    x[d] = vector_min(vector_max(x[d] + T(p.w) * delta, T(p.lower_bound)), T(p.upper_bound));
+}
+
+// Single-precision rows, runtime dim only.
+template <bool Clamp>
+static void pso_update_row_scalar32(const PSOUpdateParams& p, int dim,
+                                    float* x, float* v,
+                                    const float* pbest, const float* best,
+                                    const float* r1, const float* r2) {
+    for (int d = 0; d < dim; ++d) {
+        pso_update_element<Clamp>(p, d, x, v, pbest, best, r1, r2);
+    }
+}
+
+static void sma_update_row_scalar32(const SMAUpdateParams& p, int dim,
+                                    float* x, const float* best,
+                                    const float* r1, const float* r2) {
+    for (int d = 0; d < dim; ++d) {
+        sma_update_element(p, d, x, best, r1, r2);
+    }
+}
+
+template <int Dim>
+static void sma_update_row_scalar(const SMAUpdateParams& p, int dim,
+                                  double* x, const double* best,
+                                  const double* r1, const double* r2) {
+    const int n = Dim > 0 ? Dim : dim;
+    for (int d = 0; d < n; ++d) {
+        sma_update_element(p, d, x, best, r1, r2);
+    }
+}
+
+#if BIOOPT_X86_KERNELS
+
+template <int Dim, bool Clamp>
+__attribute__((target("avx2")))
+static void pso_update_row_avx2(const PSOUpdateParams& p, int dim,
+                                double* x, double* v,
+                                const double* pbest, const double* best,
+                                const double* r1, const double* r2) {
+    const __m256d w = _mm256_set1_pd(p.w);
+    const __m256d c1 = _mm256_set1_pd(p.c1);
+    const __m256d c2 = _mm256_set1_pd(p.c2);
+    const __m256d vmax = _mm256_set1_pd(p.v_max);
+    const __m256d vmin = _mm256_set1_pd(-p.v_max);
+    const __m256d lo = _mm256_set1_pd(p.lower_bound);
+    const __m256d hi = _mm256_set1_pd(p.upper_bound);
+    const int n = Dim > 0 ? Dim : dim;
+    int d = 0;
+    for (; d + 4 <= n; d += 4) {
+        __m256d xd = _mm256_loadu_pd(x + d);
+        __m256d cognitive = _mm256_mul_pd(_mm256_mul_pd(c1, _mm256_loadu_pd(r1 + d)),
+                                          _mm256_sub_pd(_mm256_loadu_pd(pbest + d), xd));
+        __m256d social = _mm256_mul_pd(_mm256_mul_pd(c2, _mm256_loadu_pd(r2 + d)),
+                                       _mm256_sub_pd(_mm256_loadu_pd(best + d), xd));
+        __m256d vd = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(w, _mm256_loadu_pd(v + d)), cognitive), social);
+        if (Clamp) {
+            vd = _mm256_max_pd(_mm256_min_pd(vd, vmax), vmin);
+        }
+        xd = _mm256_min_pd(_mm256_max_pd(_mm256_add_pd(xd, vd), lo), hi);
+        _mm256_storeu_pd(v + d, vd);
+        _mm256_storeu_pd(x + d, xd);
+    }
+    for (; d < n; ++d) {
+        pso_update_element<Clamp>(p, d, x, v, pbest, best, r1, r2);
+    }
+}
+
+template <int Dim>
+__attribute__((target("avx2")))
+static void sma_update_row_avx2(const SMAUpdateParams& p, int dim,
+                                double* x, const double* best,
+                                const double* r1, const double* r2) {
+    const __m256d c1 = _mm256_set1_pd(p.c1);
+    const __m256d c2 = _mm256_set1_pd(p.c2);
+    const __m256d w = _mm256_set1_pd(p.w);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d lo = _mm256_set1_pd(p.lower_bound);
+    const __m256d hi = _mm256_set1_pd(p.upper_bound);
+    const int n = Dim > 0 ? Dim : dim;
+    int d = 0;
+    for (; d + 4 <= n; d += 4) {
+        __m256d xd = _mm256_loadu_pd(x + d);
+        __m256d factor1 = _mm256_mul_pd(c1, _mm256_loadu_pd(r1 + d));
+        __m256d factor2 = _mm256_mul_pd(c2, _mm256_sub_pd(_mm256_mul_pd(_mm256_loadu_pd(r2 + d), two), one));
+        __m256d delta = _mm256_add_pd(_mm256_mul_pd(factor1, _mm256_sub_pd(_mm256_loadu_pd(best + d), xd)), factor2);
+        xd = _mm256_min_pd(_mm256_max_pd(_mm256_add_pd(xd, _mm256_mul_pd(w, delta)), lo), hi);
+        _mm256_storeu_pd(x + d, xd);
+    }
+    for (; d < n; ++d) {
+        sma_update_element(p, d, x, best, r1, r2);
+    }
+}
+
+template <bool Clamp>
+__attribute__((target("avx2")))
+static void pso_update_row_avx2_32(const PSOUpdateParams& p, int dim,
+                                   float* x, float* v,
+                                   const float* pbest, const float* best,
+                                   const float* r1, const float* r2) {
+    const __m256 w = _mm256_set1_ps(static_cast<float>(p.w));
+    const __m256 c1 = _mm256_set1_ps(static_cast<float>(p.c1));
+    const __m256 c2 = _mm256_set1_ps(static_cast<float>(p.c2));
+    const __m256 vmax = _mm256_set1_ps(static_cast<float>(p.v_max));
+    const __m256 vmin = _mm256_set1_ps(-static_cast<float>(p.v_max));
+    const __m256 lo = _mm256_set1_ps(static_cast<float>(p.lower_bound));
+    const __m256 hi = _mm256_set1_ps(static_cast<float>(p.upper_bound));
+    int d = 0;
+    for (; d + 8 <= dim; d += 8) {
+        __m256 xd = _mm256_loadu_ps(x + d);
+        __m256 cognitive = _mm256_mul_ps(_mm256_mul_ps(c1, _mm256_loadu_ps(r1 + d)),
+                                         _mm256_sub_ps(_mm256_loadu_ps(pbest + d), xd));
+        __m256 social = _mm256_mul_ps(_mm256_mul_ps(c2, _mm256_loadu_ps(r2 + d)),
+                                      _mm256_sub_ps(_mm256_loadu_ps(best + d), xd));
+        __m256 vd = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(w, _mm256_loadu_ps(v + d)), cognitive), social);
+        if (Clamp) {
+            vd = _mm256_max_ps(_mm256_min_ps(vd, vmax), vmin);
+        }
+        xd = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(xd, vd), lo), hi);
+        _mm256_storeu_ps(v + d, vd);
+        _mm256_storeu_ps(x + d, xd);
+    }
+    for (; d < dim; ++d) {
+        pso_update_element<Clamp>(p, d, x, v, pbest, best, r1, r2);
+    }
+}
+
+__attribute__((target("avx2")))
+static void sma_update_row_avx2_32(const SMAUpdateParams& p, int dim,
+                                   float* x, const float* best,
+                                   const float* r1, const float* r2) {
+    const __m256 c1 = _mm256_set1_ps(static_cast<float>(p.c1));
+    const __m256 c2 = _mm256_set1_ps(static_cast<float>(p.c2));
+    const __m256 w = _mm256_set1_ps(static_cast<float>(p.w));
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 lo = _mm256_set1_ps(static_cast<float>(p.lower_bound));
+    const __m256 hi = _mm256_set1_ps(static_cast<float>(p.upper_bound));
+    int d = 0;
+    for (; d + 8 <= dim; d += 8) {
+        __m256 xd = _mm256_loadu_ps(x + d);
+        __m256 factor1 = _mm256_mul_ps(c1, _mm256_loadu_ps(r1 + d));
+        __m256 factor2 = _mm256_mul_ps(c2, _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(r2 + d), two), one));
+        __m256 delta = _mm256_add_ps(_mm256_mul_ps(factor1, _mm256_sub_ps(_mm256_loadu_ps(best + d), xd)), factor2);
+        xd = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(xd, _mm256_mul_ps(w, delta)), lo), hi);
+        _mm256_storeu_ps(x + d, xd);
+    }
+    for (; d < dim; ++d) {
+        sma_update_element(p, d, x, best, r1, r2);
+    }
+}
+
+// GCC 12 reports a false (maybe-)uninitialized inside avx512fintrin.h.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+template <int Dim, bool Clamp>
+__attribute__((target("avx512f")))
+static void pso_update_row_avx512(const PSOUpdateParams& p, int dim,
+                                  double* x, double* v,
+                                  const double* pbest, const double* best,
+                                  const double* r1, const double* r2) {
+    const __m512d w = _mm512_set1_pd(p.w);
+    const __m512d c1 = _mm512_set1_pd(p.c1);
+    const __m512d c2 = _mm512_set1_pd(p.c2);
+    const __m512d vmax = _mm512_set1_pd(p.v_max);
+    const __m512d vmin = _mm512_set1_pd(-p.v_max);
+    const __m512d lo = _mm512_set1_pd(p.lower_bound);
+    const __m512d hi = _mm512_set1_pd(p.upper_bound);
+    const int n = Dim > 0 ? Dim : dim;
+    int d = 0;
+    for (; d + 8 <= n; d += 8) {
+        __m512d xd = _mm512_loadu_pd(x + d);
+        __m512d cognitive = _mm512_mul_pd(_mm512_mul_pd(c1, _mm512_loadu_pd(r1 + d)),
+                                          _mm512_sub_pd(_mm512_loadu_pd(pbest + d), xd));
+        __m512d social = _mm512_mul_pd(_mm512_mul_pd(c2, _mm512_loadu_pd(r2 + d)),
+                                       _mm512_sub_pd(_mm512_loadu_pd(best + d), xd));
+        __m512d vd = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(w, _mm512_loadu_pd(v + d)), cognitive), social);
+        if (Clamp) {
+            vd = _mm512_max_pd(_mm512_min_pd(vd, vmax), vmin);
+        }
+        xd = _mm512_min_pd(_mm512_max_pd(_mm512_add_pd(xd, vd), lo), hi);
+        _mm512_storeu_pd(v + d, vd);
+        _mm512_storeu_pd(x + d, xd);
+    }
+    for (; d < n; ++d) {
+        pso_update_element<Clamp>(p, d, x, v, pbest, best, r1, r2);
+    }
+}
+
+template <int Dim>
+__attribute__((target("avx512f")))
+static void sma_update_row_avx512(const SMAUpdateParams& p, int dim,
+                                  double* x, const double* best,
+                                  const double* r1, const double* r2) {
+    const __m512d c1 = _mm512_set1_pd(p.c1);
+    const __m512d c2 = _mm512_set1_pd(p.c2);
+    const __m512d w = _mm512_set1_pd(p.w);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d lo = _mm512_set1_pd(p.lower_bound);
+    const __m512d hi = _mm512_set1_pd(p.upper_bound);
+    const int n = Dim > 0 ? Dim : dim;
+    int d = 0;
+    for (; d + 8 <= n; d += 8) {
+        __m512d xd = _mm512_loadu_pd(x + d);
+        __m512d factor1 = _mm512_mul_pd(c1, _mm512_loadu_pd(r1 + d));
+        __m512d factor2 = _mm512_mul_pd(c2, _mm512_sub_pd(_mm512_mul_pd(_mm512_loadu_pd(r2 + d), two), one));
+        __m512d delta = _mm512_add_pd(_mm512_mul_pd(factor1, _mm512_sub_pd(_mm512_loadu_pd(best + d), xd)), factor2);
+        xd = _mm512_min_pd(_mm512_max_pd(_mm512_add_pd(xd, _mm512_mul_pd(w, delta)), lo), hi);
+        _mm512_storeu_pd(x + d, xd);
+    }
+    for (; d < n; ++d) {
+        sma_update_element(p, d, x, best, r1, r2);
+    }
+}
+
+template <bool Clamp>
+__attribute__((target("avx512f")))
+static void pso_update_row_avx512_32(const PSOUpdateParams& p, int dim,
+                                     float* x, float* v,
+                                     const float* pbest, const float* best,
+                                     const float* r1, const float* r2) {
+    const __m512 w = _mm512_set1_ps(static_cast<float>(p.w));
+    const __m512 c1 = _mm512_set1_ps(static_cast<float>(p.c1));
+    const __m512 c2 = _mm512_set1_ps(static_cast<float>(p.c2));
+    const __m512 vmax = _mm512_set1_ps(static_cast<float>(p.v_max));
+    const __m512 vmin = _mm512_set1_ps(-static_cast<float>(p.v_max));
+    const __m512 lo = _mm512_set1_ps(static_cast<float>(p.lower_bound));
+    const __m512 hi = _mm512_set1_ps(static_cast<float>(p.upper_bound));
+    int d = 0;
+    for (; d + 16 <= dim; d += 16) {
+        __m512 xd = _mm512_loadu_ps(x + d);
+        __m512 cognitive = _mm512_mul_ps(_mm512_mul_ps(c1, _mm512_loadu_ps(r1 + d)),
+                                         _mm512_sub_ps(_mm512_loadu_ps(pbest + d), xd));
+        __m512 social = _mm512_mul_ps(_mm512_mul_ps(c2, _mm512_loadu_ps(r2 + d)),
+                                      _mm512_sub_ps(_mm512_loadu_ps(best + d), xd));
+        __m512 vd = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(w, _mm512_loadu_ps(v + d)), cognitive), social);
+        if (Clamp) {
+            vd = _mm512_max_ps(_mm512_min_ps(vd, vmax), vmin);
+        }
+        xd = _mm512_min_ps(_mm512_max_ps(_mm512_add_ps(xd, vd), lo), hi);
+        _mm512_storeu_ps(v + d, vd);
+        _mm512_storeu_ps(x + d, xd);
+    }
+    for (; d < dim; ++d) {
+        pso_update_element<Clamp>(p, d, x, v, pbest, best, r1, r2);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void sma_update_row_avx512_32(const SMAUpdateParams& p, int dim,
+                                     float* x, const float* best,
+                                     const float* r1, const float* r2) {
+    const __m512 c1 = _mm512_set1_ps(static_cast<float>(p.c1));
+    const __m512 c2 = _mm512_set1_ps(static_cast<float>(p.c2));
+    const __m512 w = _mm512_set1_ps(static_cast<float>(p.w));
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 two = _mm512_set1_ps(2.0f);
+    const __m512 lo = _mm512_set1_ps(static_cast<float>(p.lower_bound));
+    const __m512 hi = _mm512_set1_ps(static_cast<float>(p.upper_bound));
+    int d = 0;
+    for (; d + 16 <= dim; d += 16) {
+        __m512 xd = _mm512_loadu_ps(x + d);
+        __m512 factor1 = _mm512_mul_ps(c1, _mm512_loadu_ps(r1 + d));
+        __m512 factor2 = _mm512_mul_ps(c2, _mm512_sub_ps(_mm512_mul_ps(_mm512_loadu_ps(r2 + d), two), one));
+        __m512 delta = _mm512_add_ps(_mm512_mul_ps(factor1, _mm512_sub_ps(_mm512_loadu_ps(best + d), xd)), factor2);
+        xd = _mm512_min_ps(_mm512_max_ps(_mm512_add_ps(xd, _mm512_mul_ps(w, delta)), lo), hi);
+        _mm512_storeu_ps(x + d, xd);
+    }
+    for (; d < dim; ++d) {
+        sma_update_element(p, d, x, best, r1, r2);
+    }
+}
+
+#pragma GCC diagnostic pop
+
+#endif // BIOOPT_X86_KERNELS
+
+enum class KernelISA { Scalar, AVX2, AVX512 };
+
+// Widest supported instruction set, optionally capped by BIOOPT_KERNEL_ISA
+// ("scalar", "avx2" or "avx512") for benchmarking and debugging.
+static KernelISA detect_isa() {
+    KernelISA isa = KernelISA::Scalar;
+#if BIOOPT_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        isa = KernelISA::AVX512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        isa = KernelISA::AVX2;
+    }
+#endif
+    const char* requested = std::getenv("BIOOPT_KERNEL_ISA");
+    if (requested) {
+        if (std::strcmp(requested, "scalar") == 0) {
+            isa = KernelISA::Scalar;
+        } else if (std::strcmp(requested, "avx2") == 0 && isa == KernelISA::AVX512) {
+            isa = KernelISA::AVX2;
+        }
+    }
+    return isa;
+}
+
+static KernelISA active_isa() {
+    static const KernelISA isa = detect_isa();
+    return isa;
+}
+
+template <int Dim>
+static PSOKernel pso_kernel_for(KernelISA isa, bool clamp) {
+#if BIOOPT_X86_KERNELS
+    switch (isa) {
+        case KernelISA::AVX512:
+            return clamp ? pso_update_row_avx512<Dim, true> : pso_update_row_avx512<Dim, false>;
+        case KernelISA::AVX2:
+            return clamp ? pso_update_row_avx2<Dim, true> : pso_update_row_avx2<Dim, false>;
+        default: break;
+    }
+#else
+    (void)isa;
+#endif
+    return clamp ? pso_update_row_scalar<Dim, true> : pso_update_row_scalar<Dim, false>;
+}
+
+template <int Dim>
+static SMAKernel sma_kernel_for(KernelISA isa) {
+#if BIOOPT_X86_KERNELS
+    switch (isa) {
+        case KernelISA::AVX512: return sma_update_row_avx512<Dim>;
+        case KernelISA::AVX2: return sma_update_row_avx2<Dim>;
+        default: break;
+    }
+#else
+    (void)isa;
+#endif
+    return sma_update_row_scalar<Dim>;
+}
+
+// Index 0 holds the runtime-dim kernels, index d the ones fixed to dim d.
+template <std::size_t... Dims>
+static PSOKernel pick_pso_kernel(int index, bool clamp, std::index_sequence<Dims...>) {
+    static PSOKernel (*const pickers[])(KernelISA, bool) = {&pso_kernel_for<static_cast<int>(Dims)>...};
+    return pickers[index](active_isa(), clamp);
+}
+
+template <std::size_t... Dims>
+static SMAKernel pick_sma_kernel(int index, std::index_sequence<Dims...>) {
+    static SMAKernel (*const pickers[])(KernelISA) = {&sma_kernel_for<static_cast<int>(Dims)>...};
+    return pickers[index](active_isa());
+}
+
+static int fixed_dim_index(int dim) {
+    return (dim >= 1 && dim <= MAX_FIXED_KERNEL_DIM) ? dim : 0;
+}
+
+PSOKernel select_pso_kernel(int dim, bool clamp_velocity) {
+    return pick_pso_kernel(fixed_dim_index(dim), clamp_velocity,
+                           std::make_index_sequence<MAX_FIXED_KERNEL_DIM + 1>());
+}
+
+SMAKernel select_sma_kernel(int dim) {
+    return pick_sma_kernel(fixed_dim_index(dim), std::make_index_sequence<MAX_FIXED_KERNEL_DIM + 1>());
+}
+
+PSOKernel32 select_pso_kernel32(bool clamp_velocity) {
+#if BIOOPT_X86_KERNELS
+    switch (active_isa()) {
+        case KernelISA::AVX512:
+            return clamp_velocity ? pso_update_row_avx512_32<true> : pso_update_row_avx512_32<false>;
+        case KernelISA::AVX2:
+            return clamp_velocity ? pso_update_row_avx2_32<true> : pso_update_row_avx2_32<false>;
+        default: break;
+    }
+#endif
+    return clamp_velocity ? pso_update_row_scalar32<true> : pso_update_row_scalar32<false>;
+}
+
+SMAKernel32 select_sma_kernel32() {
+#if BIOOPT_X86_KERNELS
+    switch (active_isa()) {
+        case KernelISA::AVX512: return sma_update_row_avx512_32;
+        case KernelISA::AVX2: return sma_update_row_avx2_32;
+        default: break;
+    }
+#endif
+    return sma_update_row_scalar32;
+}
+
+void pso_update_row(const PSOUpdateParams& params, int dim,
+                    double* position, double* velocity,
+                    const double* pbest, const double* best,
+                    const double* r1, const double* r2) {
+    static const PSOKernel clamped = pso_kernel_for<0>(active_isa(), true);
+    static const PSOKernel unclamped = pso_kernel_for<0>(active_isa(), false);
+    (params.v_max > 0.0 ? clamped : unclamped)(params, dim, position, velocity, pbest, best, r1, r2);
+}
+
+void sma_update_row(const SMAUpdateParams& params, int dim,
+                    double* position, const double* best,
+                    const double* r1, const double* r2) {
+    static const SMAKernel update = sma_kernel_for<0>(active_isa());
+    update(params, dim, position, best, r1, r2);
+}
+
+const char* kernel_isa() {
+    switch (active_isa()) {
+        case KernelISA::AVX512: return "avx512";
+        case KernelISA::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,224 @@
+#include "multi_run.h"
+#include <algorithm>
+#include <stdexcept>
+
+MultiRun::MultiRun(int num_threads) {
+    set_num_threads(num_threads);
+}
+
+void MultiRun::add_run(BaseOptimizer* run) {
+    if (!run) {
+        throw std::runtime_error("Run must not be null.");
+    }
+    if (!runs.empty() && run->get_dim() != runs[0]->get_dim()) {
+        throw std::runtime_error("All runs must have the same dimension.");
+    }
+    if (std::find(runs.begin(), runs.end(), run) != runs.end()) {
+        throw std::runtime_error("Run was already added.");
+    }
+    runs.push_back(run);
+}
+
+void MultiRun::set_batch_objective(BaseOptimizer::BatchObjectiveFunction obj) {
+    batch_objective_function = obj;
+    set_native_objective(nullptr);
+}
+
+void MultiRun::set_native_objective(BaseOptimizer::NativeObjective fn, void* user_data, bool thread_safe,
+                                    std::shared_ptr<const void> owner) {
+    native_objective = fn;
+    native_user_data = user_data;
+    native_owner = std::move(owner);
+    if (fn) {
+        objective_thread_safe = thread_safe;
+        batch_objective_function = nullptr;
+    }
+}
+
+void MultiRun::set_num_threads(int num_threads) {
+    if (num_threads == 1) {
+        thread_pool.reset();
+        return;
+    }
+    thread_pool.reset(new ThreadPool(num_threads));
+    if (thread_pool->size() == 1) {
+        thread_pool.reset();
+    }
+}
+
+void MultiRun::parallel_for(int count, const std::function<void(int, int)>& body) {
+    if (thread_pool) {
+        // One run per chunk: runs differ in cost.
+        thread_pool->parallel_for(count, 1, body);
+        return;
+    }
+    body(0, count);
+}
+
+void MultiRun::optimize(int iterations) {
+    if (runs.empty()) {
+        throw std::runtime_error("Multi run has no runs.");
+    }
+    if (!batch_objective_function && !native_objective) {
+        throw std::runtime_error("Objective function not set!");
+    }
+    int k_count = size();
+    int dim = runs[0]->get_dim();
+
+    // Per run: iterations still to go, whether the initial population is
+    // still to be evaluated, and whether it takes part in the next step.
+    // Mirrors BaseOptimizer::optimize().
+    std::vector<int> remaining(k_count);
+    std::vector<char> initial(k_count);
+    std::vector<char> active(k_count);
+    for (int k = 0; k < k_count; ++k) {
+        BaseOptimizer* run = runs[k];
+        remaining[k] = run->begin_run(iterations);
+        initial[k] = !run->has_started();
+        active[k] = initial[k] || (!run->stop_requested() && remaining[k] > 0);
+    }
+
+    std::vector<int> stepping;
+    std::vector<const Population*> candidates(k_count);
+    std::vector<const std::vector<int>*> fresh_rows(k_count);
+    std::vector<int> offsets(k_count + 1);
+    told.resize(k_count);
+    for (;;) {
+        stepping.clear();
+        for (int k = 0; k < k_count; ++k) {
+            if (active[k]) {
+                stepping.push_back(k);
+            }
+        }
+        int count = static_cast<int>(stepping.size());
+        if (count == 0) {
+            break;
+        }
+
+        parallel_for(count, [&](int begin, int end) {
+            for (int j = begin; j < end; ++j) {
+                candidates[j] = &runs[stepping[j]]->ask();
+            }
+        });
+
+        // Only rows that need evaluating go into the block (GA carries its
+        // elites over); the others are told their current fitness.
+        offsets[0] = 0;
+        for (int j = 0; j < count; ++j) {
+            const std::vector<int>* fresh = runs[stepping[j]]->candidate_rows();
+            fresh_rows[j] = fresh;
+            offsets[j + 1] = offsets[j] + (fresh ? static_cast<int>(fresh->size()) : candidates[j]->rows());
+        }
+        int rows = offsets[count];
+        if (block.rows() < rows || block.cols() != dim) {
+            block.resize(rows, dim);
+        }
+        block_fitness.resize(block.rows());
+        parallel_for(count, [&](int begin, int end) {
+            for (int j = begin; j < end; ++j) {
+                const Population& from = *candidates[j];
+                if (!fresh_rows[j]) {
+                    std::copy(from.data(), from.data() + from.size(), block.row(offsets[j]).data());
+                    continue;
+                }
+                int r = offsets[j];
+                for (int i : *fresh_rows[j]) {
+                    block.copy_row(r++, from, i);
+                }
+            }
+        });
+
+        evaluate_block(rows);
+
+        parallel_for(count, [&](int begin, int end) {
+            for (int j = begin; j < end; ++j) {
+                int k = stepping[j];
+                BaseOptimizer* run = runs[k];
+                const double* fitness = block_fitness.data() + offsets[j];
+                if (fresh_rows[j]) {
+                    std::vector<double>& all = told[k];
+                    all = run->get_fitness();
+                    int r = 0;
+                    for (int i : *fresh_rows[j]) {
+                        all[i] = fitness[r++];
+                    }
+                    fitness = all.data();
+                }
+                run->tell(fitness, candidates[j]->rows());
+                if (initial[k]) {
+                    initial[k] = false;
+                    active[k] = !run->stop_requested() && remaining[k] > 0;
+                } else {
+                    --remaining[k];
+                    active[k] = run->get_stop_reason() == StopReason::NotStopped && remaining[k] > 0;
+                }
+            }
+        });
+    }
+
+    for (BaseOptimizer* run : runs) {
+        run->end_run();
+    }
+}
+
+void MultiRun::evaluate_block(int rows) {
+    if (rows == 0) {
+        return;
+    }
+    if (batch_objective_function) {
+        batch_objective_function(block.data(), rows, block.cols(), block_fitness.data());
+        return;
+    }
+    auto evaluate_range = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            block_fitness[i] = native_objective(block.row(i).data(), static_cast<std::size_t>(block.cols()),
+                                                native_user_data);
+        }
+    };
+    if (thread_pool && objective_thread_safe) {
+        thread_pool->parallel_for(rows, 0, evaluate_range);
+    } else {
+        evaluate_range(0, rows);
+    }
+}
+
+std::vector<double> MultiRun::get_best_fitness() const {
+    std::vector<double> out;
+    for (const BaseOptimizer* run : runs) {
+        out.push_back(run->get_best_fitness());
+    }
+    return out;
+}
+
+std::vector<double> MultiRun::get_best_solutions() const {
+    std::vector<double> out;
+    for (const BaseOptimizer* run : runs) {
+        const std::vector<double>& best = run->get_best_solution();
+        out.insert(out.end(), best.begin(), best.end());
+    }
+    return out;
+}
+
+std::vector<int> MultiRun::get_iterations() const {
+    std::vector<int> out;
+    for (const BaseOptimizer* run : runs) {
+        out.push_back(run->get_iteration());
+    }
+    return out;
+}
+
+std::vector<uint64_t> MultiRun::get_evaluation_counts() const {
+    std::vector<uint64_t> out;
+    for (const BaseOptimizer* run : runs) {
+        out.push_back(run->get_evaluation_count());
+    }
+    return out;
+}
+
+std::vector<StopReason> MultiRun::get_stop_reasons() const {
+    std::vector<StopReason> out;
+    for (const BaseOptimizer* run : runs) {
+        out.push_back(run->get_stop_reason());
+    }
+    return out;
+}
@@ -1,3 +1,811 @@
 #include "base_optimizer.h"
+#include "population.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
 
-// Empty for now, but can contain shared optimizer utilities
+namespace {
+
+// Call a batch objective on the listed rows (all rows when `rows` is null).
+// Rows are used in place when they are already contiguous and of the type
+// the objective takes; otherwise they are gathered, and converted, into
+// `staging` first so the objective still sees one contiguous block.
+template <typename S, typename T, typename Batch>
+void evaluate_batch(const Batch& objective, const BasicPopulation<T>& positions, BasicPopulation<S>& staging,
+                    std::vector<double>& staging_fitness, std::vector<double>& fitness,
+                    const int* rows, int count, int dim) {
+    if constexpr (std::is_same<S, T>::value) {
+        if (!rows) {
+            objective(positions.data(), count, dim, fitness.data());
+            return;
+        }
+    }
+    if (staging.rows() < count) {
+        staging.resize(count, dim);
+    }
+    staging_fitness.resize(staging.rows());
+    for (int k = 0; k < count; ++k) {
+        RowSpan<const T> row = positions.row(rows ? rows[k] : k);
+        std::copy(row.begin(), row.end(), staging.row(k).data());
+    }
+    objective(staging.data(), count, dim, staging_fitness.data());
+    for (int k = 0; k < count; ++k) {
+        fitness[rows ? rows[k] : k] = staging_fitness[k];
+    }
+}
+
+// Row i as doubles: in place for double populations, widened into `scratch`
+// (dim values) otherwise.
+template <typename T>
+const double* double_row(const BasicPopulation<T>& positions, int i, double* scratch) {
+    if constexpr (std::is_same<T, double>::value) {
+        (void)scratch;
+        return positions.row(i).data();
+    } else {
+        RowSpan<const T> row = positions.row(i);
+        std::copy(row.begin(), row.end(), scratch);
+        return scratch;
+    }
+}
+
+// Random stream lane of surrogate exploration draws.
+const uint32_t SURROGATE_LANE = 4;
+
+}  // namespace
+
+void BaseOptimizer::set_objective(ObjectiveFunction obj, bool thread_safe) {
+    objective_function = obj;
+    objective_thread_safe = thread_safe;
+    batch_objective_function = nullptr;
+    batch_objective_function32 = nullptr;
+    set_native_objective(nullptr);
+}
+
+void BaseOptimizer::set_batch_objective(BatchObjectiveFunction obj, BatchObjectiveFunction32 obj32) {
+    batch_objective_function = obj;
+    batch_objective_function32 = obj ? obj32 : nullptr;
+    objective_function = nullptr;
+    set_native_objective(nullptr);
+}
+
+void BaseOptimizer::set_native_objective(NativeObjective fn, void* user_data, bool thread_safe,
+                                         std::shared_ptr<const void> owner) {
+    native_objective = fn;
+    native_user_data = user_data;
+    native_owner = std::move(owner);
+    if (fn) {
+        objective_thread_safe = thread_safe;
+        objective_function = nullptr;
+        batch_objective_function = nullptr;
+        batch_objective_function32 = nullptr;
+    }
+}
+
+void BaseOptimizer::set_num_threads(int num_threads) {
+    if (num_threads == 1) {
+        thread_pool.reset();
+        return;
+    }
+    thread_pool.reset(new ThreadPool(num_threads));
+    if (thread_pool->size() == 1) {
+        thread_pool.reset();
+    }
+}
+
+int BaseOptimizer::get_num_threads() const {
+    return thread_pool ? thread_pool->size() : 1;
+}
+
+bool BaseOptimizer::has_objective() const {
+    return static_cast<bool>(objective_function) || static_cast<bool>(batch_objective_function) ||
+           native_objective != nullptr;
+}
+
+void BaseOptimizer::evaluate(const Population& positions, std::vector<double>& fitness) {
+    fitness.resize(positions.rows());
+    evaluate_rows(positions, fitness, nullptr, positions.rows());
+}
+
+void BaseOptimizer::evaluate(const Population& positions, std::vector<double>& fitness, const std::vector<int>& rows) {
+    fitness.resize(positions.rows());
+    evaluate_rows(positions, fitness, rows.data(), static_cast<int>(rows.size()));
+}
+
+void BaseOptimizer::evaluate(const Population32& positions, std::vector<double>& fitness) {
+    fitness.resize(positions.rows());
+    evaluate_rows(positions, fitness, nullptr, positions.rows());
+}
+
+void BaseOptimizer::evaluate_candidates() {
+    if (const Population32* narrow = get_population32()) {
+        evaluate(*narrow, fitness_buffer());
+    } else {
+        evaluate(get_population(), fitness_buffer());
+    }
+}
+
+// `rows` == nullptr means every row in order.
+template <typename T>
+void BaseOptimizer::evaluate_rows(const BasicPopulation<T>& positions, std::vector<double>& fitness,
+                                  const int* rows, int count) {
+    if (fitness_cache.enabled()) {
+        // Lookups are serial and cheap next to the objective; only misses go on.
+        widened_row.resize(dim);
+        pending_rows.clear();
+        for (int k = 0; k < count; ++k) {
+            int i = rows ? rows[k] : k;
+            if (!fitness_cache.lookup(double_row(positions, i, widened_row.data()), fitness[i])) {
+                pending_rows.push_back(i);
+            }
+        }
+        if (static_cast<int>(pending_rows.size()) < count || rows) {
+            rows = pending_rows.data();
+        }
+        count = static_cast<int>(pending_rows.size());
+    }
+    int screened = 0;
+    if (surrogate.ready()) {
+        int selected = screen_rows(positions, rows, count);
+        screened = count - selected;
+        count = selected;
+    }
+    if (count == 0) {
+        return;
+    }
+    evaluation_count += count;
+
+    if (batch_objective_function) {
+        bool narrow_batch = false;
+        if constexpr (std::is_same<T, float>::value) {
+            narrow_batch = static_cast<bool>(batch_objective_function32);
+        }
+        if (narrow_batch) {
+            evaluate_batch(batch_objective_function32, positions, staging32, staging_fitness, fitness, rows, count, dim);
+        } else {
+            evaluate_batch(batch_objective_function, positions, staging, staging_fitness, fitness, rows, count, dim);
+        }
+    } else if (native_objective) {
+        // Native objectives read double rows where they are; float rows are
+        // widened into a per-thread buffer.
+        auto evaluate_range = [&](int begin, int end) {
+            std::vector<double> scratch(std::is_same<T, double>::value ? 0 : dim);
+            for (int k = begin; k < end; ++k) {
+                int i = rows ? rows[k] : k;
+                fitness[i] = native_objective(double_row(positions, i, scratch.data()),
+                                              static_cast<std::size_t>(dim), native_user_data);
+            }
+        };
+        if (thread_pool && objective_thread_safe) {
+            thread_pool->parallel_for(count, 0, evaluate_range);
+        } else {
+            evaluate_range(0, count);
+        }
+    } else {
+        // Per-individual objectives take a std::vector, so each thread stages rows in its own buffer.
+        auto evaluate_range = [&](int begin, int end) {
+            std::vector<double> individual(dim);
+            for (int k = begin; k < end; ++k) {
+                int i = rows ? rows[k] : k;
+                RowSpan<const T> row = positions.row(i);
+                std::copy(row.begin(), row.end(), individual.begin());
+                fitness[i] = objective_function(individual);
+            }
+        };
+        if (thread_pool && objective_thread_safe) {
+            thread_pool->parallel_for(count, 0, evaluate_range);
+        } else {
+            evaluate_range(0, count);
+        }
+    }
+
+    if (fitness_cache.enabled()) {
+        for (int k = 0; k < count; ++k) {
+            int i = rows ? rows[k] : k;
+            fitness_cache.insert(double_row(positions, i, widened_row.data()), fitness[i]);
+        }
+    }
+
+    if (surrogate.enabled()) {
+        widened_row.resize(dim);
+        for (int k = 0; k < count; ++k) {
+            int i = rows ? rows[k] : k;
+            surrogate.insert(double_row(positions, i, widened_row.data()), fitness[i]);
+        }
+    }
+    if (screened > 0) {
+        // Predictions rank below the worst best-ranked candidate just evaluated.
+        auto better = [this](double a, double b) { return minimize ? a < b : a > b; };
+        double floor = fitness[promising_rows[0]];
+        for (int i : promising_rows) {
+            floor = better(floor, fitness[i]) ? fitness[i] : floor;
+        }
+        for (int k = 0; k < screened; ++k) {
+            double value = screened_fitness[k];
+            fitness[screened_rows[k]] = better(value, floor) ? floor : value;
+        }
+        surrogate.count_screened(screened);
+    }
+}
+
+template <typename T>
+int BaseOptimizer::screen_rows(const BasicPopulation<T>& positions, const int*& rows, int count) {
+    const SurrogateSettings& settings = surrogate.get_settings();
+    int keep = std::max(1, static_cast<int>(std::ceil(settings.evaluate_fraction * count)));
+    int explore = static_cast<int>(std::round(settings.explore_fraction * count));
+    if (keep + explore >= count) {
+        return count;
+    }
+
+    predicted.resize(count);
+    parallel_rows(count, [&](int begin, int end) {
+        std::vector<double> scratch(std::is_same<T, double>::value ? 0 : dim);
+        for (int k = begin; k < end; ++k) {
+            predicted[k] = surrogate.predict(double_row(positions, rows ? rows[k] : k, scratch.data()));
+        }
+    });
+
+    // Best predictions first (ties by position), then a random exploration
+    // quota from the rest, drawn from this step's own stream.
+    screen_order.resize(count);
+    for (int k = 0; k < count; ++k) {
+        screen_order[k] = k;
+    }
+    std::sort(screen_order.begin(), screen_order.end(), [&](int a, int b) {
+        if (predicted[a] != predicted[b]) {
+            return minimize ? predicted[a] < predicted[b] : predicted[a] > predicted[b];
+        }
+        return a < b;
+    });
+    RandomStream stream(rng_seed, rng_step, 0, SURROGATE_LANE);
+    for (int e = keep; e < keep + explore; ++e) {
+        std::swap(screen_order[e], screen_order[stream.uniform_int(e, count - 1)]);
+    }
+
+    promising_rows.clear();
+    for (int e = 0; e < keep; ++e) {
+        int k = screen_order[e];
+        promising_rows.push_back(rows ? rows[k] : k);
+    }
+    screened_rows.clear();
+    screened_fitness.clear();
+    for (int e = keep + explore; e < count; ++e) {
+        int k = screen_order[e];
+        screened_rows.push_back(rows ? rows[k] : k);
+        screened_fitness.push_back(predicted[k]);
+    }
+    // The objective sees the selected rows in their original order.
+    std::sort(screen_order.begin(), screen_order.begin() + keep + explore);
+    selected_rows.clear();
+    for (int e = 0; e < keep + explore; ++e) {
+        int k = screen_order[e];
+        selected_rows.push_back(rows ? rows[k] : k);
+    }
+    rows = selected_rows.data();
+    return keep + explore;
+}
+
+void BaseOptimizer::parallel_rows(int count, const std::function<void(int, int)>& body) {
+    if (thread_pool) {
+        thread_pool->parallel_for(count, 0, body);
+        return;
+    }
+    body(0, count);
+}
+
+void BaseOptimizer::record_history(bool force) {
+    if (force || population_history.due(iteration)) {
+        Instrumentation::Scope scope(instrumentation, Phase::History);
+        if (const Population32* narrow = get_population32()) {
+            population_history.record(*narrow, get_fitness(), get_best_fitness(), iteration);
+        } else {
+            population_history.record(get_population(), get_fitness(), get_best_fitness(), iteration);
+        }
+    }
+}
+
+void BaseOptimizer::optimize(int iterations) {
+    if (!has_objective()) {
+        throw std::runtime_error("Objective function not set!");
+    }
+    continue_run(begin_run(iterations));
+    end_run();
+}
+
+void BaseOptimizer::continue_run(int count) {
+    if (!has_objective()) {
+        throw std::runtime_error("Objective function not set!");
+    }
+    if (!started) {
+        step();
+    }
+    if (!should_stop()) {
+        if (async_mode) {
+            // Finish a generational step left open by ask() before going asynchronous.
+            if (asked && count > 0) {
+                step();
+                --count;
+            }
+            if (stop_reason == StopReason::NotStopped) {
+                run_async(count);
+            }
+        } else {
+            for (int k = 0; k < count && stop_reason == StopReason::NotStopped; ++k) {
+                step();
+            }
+        }
+    }
+    settle_population();
+}
+
+int BaseOptimizer::begin_run(int iterations) {
+    // A straggler from an earlier timeout must not overlap this run's evaluations.
+    join_async_stragglers();
+    int count = (iterations == -1) ? max_iter : iterations;
+    // Schedules aim for max_iter unless this run goes past it.
+    horizon = std::max(max_iter, iteration + count);
+    stop_reason = StopReason::NotStopped;
+    deadline = std::chrono::steady_clock::time_point::max();
+    if (termination.max_seconds > 0.0) {
+        deadline = std::chrono::steady_clock::now() +
+                   std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                       std::chrono::duration<double>(termination.max_seconds));
+    }
+    instrumentation.reserve(static_cast<std::size_t>(std::max(count, 0)) + (started ? 0 : 1));
+    return count;
+}
+
+void BaseOptimizer::end_run() {
+    settle_population();
+    if (stop_reason == StopReason::NotStopped) {
+        stop_reason = StopReason::MaxIterations;
+    }
+    if (!store_history_each_iter) {
+        record_history(true);
+    }
+}
+
+const Population& BaseOptimizer::ask() {
+    prepare_candidates();
+    settle_population();
+    return get_population();
+}
+
+const Population32& BaseOptimizer::ask32() {
+    if (precision != Precision::Float32) {
+        throw std::runtime_error("ask32() needs float32 mode.");
+    }
+    prepare_candidates();
+    settle_population();
+    return *get_population32();
+}
+
+void BaseOptimizer::prepare_candidates() {
+    if (!asked) {
+        if (started) {
+            // An ask()/tell() loop outside begin_run() may go past the horizon;
+            // stretch it as begin_run() does for a run that goes past max_iter.
+            horizon = std::max(horizon, iteration + 1);
+            Instrumentation::Scope scope(instrumentation, Phase::Update);
+            generate();
+            population_changed();
+        }
+        asked = true;
+    }
+}
+
+void BaseOptimizer::tell(const double* fitness, int count) {
+    if (!asked) {
+        throw std::runtime_error("tell() called without a matching ask().");
+    }
+    std::vector<double>& buffer = fitness_buffer();
+    if (count != static_cast<int>(buffer.size())) {
+        throw std::runtime_error("tell() needs one fitness value per candidate.");
+    }
+    // Rows carried over unchanged keep their fitness; only the others are
+    // taken from `fitness` and counted as evaluations.
+    if (const std::vector<int>* rows = candidate_rows()) {
+        for (int i : *rows) {
+            buffer[i] = fitness[i];
+        }
+        evaluation_count += rows->size();
+    } else {
+        std::copy(fitness, fitness + count, buffer.begin());
+        evaluation_count += count;
+    }
+    finish_step();
+}
+
+void BaseOptimizer::step() {
+    prepare_candidates();
+    {
+        Instrumentation::Scope scope(instrumentation, Phase::Evaluation);
+        evaluate_candidates();
+    }
+    finish_step();
+}
+
+void BaseOptimizer::finish_step() {
+    asked = false;
+    if (!started) {
+        {
+            Instrumentation::Scope scope(instrumentation, Phase::Update);
+            absorb_initial();
+        }
+        started = true;
+        restart_stagnation();
+        if (instrumentation.collecting()) {
+            record_statistics();
+        }
+        if (store_history_each_iter) {
+            record_history();
+        }
+    } else {
+        {
+            Instrumentation::Scope scope(instrumentation, Phase::Update);
+            absorb();
+        }
+        end_iteration();
+    }
+}
+
+void BaseOptimizer::end_iteration() {
+    ++iteration;
+    if (verbose) {
+        // No flush: stdout is flushed by the stream when it sees fit.
+        std::cout << "Iteration " << iteration
+                  << " Best Fitness: " << get_best_fitness() << '\n';
+    }
+    if (instrumentation.collecting()) {
+        record_statistics();
+    }
+    if (store_history_each_iter) {
+        record_history();
+    }
+    if (progress_callback && iteration % callback_every == 0) {
+        settle_population();
+        if (progress_callback(*this) && stop_reason == StopReason::NotStopped) {
+            stop_reason = StopReason::Callback;
+        }
+    }
+    should_stop();
+}
+
+void BaseOptimizer::record_statistics() {
+    const std::vector<double>& values = get_fitness();
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+    double mean = values.empty() ? 0.0 : sum / values.size();
+    instrumentation.record(iteration, get_best_fitness(), mean,
+                           current_diversity(),
+                           evaluation_count);
+}
+
+double BaseOptimizer::current_diversity() const {
+    if (const Population32* narrow = get_population32()) {
+        return population_diversity(*narrow, lower_bound, upper_bound);
+    }
+    return population_diversity(get_population(), lower_bound, upper_bound);
+}
+
+void BaseOptimizer::set_progress_callback(ProgressCallback callback, int every) {
+    if (every < 1) {
+        throw std::runtime_error("Callback interval must be at least 1.");
+    }
+    progress_callback = std::move(callback);
+    callback_every = every;
+}
+
+void BaseOptimizer::set_termination(const TerminationCriteria& criteria) {
+    if (criteria.max_seconds < 0.0 || criteria.stagnation_window < 0 ||
+        criteria.stagnation_epsilon < 0.0 || criteria.min_diversity < 0.0) {
+        throw std::runtime_error("Termination criteria must be non-negative.");
+    }
+    termination = criteria;
+    if (started) {
+        restart_stagnation();
+    }
+}
+
+void BaseOptimizer::restart_stagnation() {
+    stagnation_best = get_best_fitness();
+    stagnation_since = iteration;
+}
+
+bool BaseOptimizer::budget_exhausted() {
+    if (stop_reason != StopReason::NotStopped) {
+        return true;
+    }
+    if (termination.max_evaluations > 0 && evaluation_count >= termination.max_evaluations) {
+        stop_reason = StopReason::MaxEvaluations;
+    } else if (termination.max_seconds > 0.0 && std::chrono::steady_clock::now() >= deadline) {
+        stop_reason = StopReason::Deadline;
+    }
+    return stop_reason != StopReason::NotStopped;
+}
+
+bool BaseOptimizer::should_stop() {
+    if (budget_exhausted()) {
+        return true;
+    }
+    double best = get_best_fitness();
+    if (termination.has_target &&
+        (minimize ? best <= termination.target_fitness : best >= termination.target_fitness)) {
+        stop_reason = StopReason::TargetReached;
+    } else if (termination.stagnation_window > 0) {
+        double improvement = minimize ? stagnation_best - best : best - stagnation_best;
+        if (improvement > termination.stagnation_epsilon) {
+            restart_stagnation();
+        } else if (iteration - stagnation_since >= termination.stagnation_window) {
+            stop_reason = StopReason::Stagnation;
+        }
+    }
+    if (stop_reason == StopReason::NotStopped && termination.min_diversity > 0.0 &&
+        current_diversity() < termination.min_diversity) {
+        stop_reason = StopReason::DiversityCollapse;
+    }
+    return stop_reason != StopReason::NotStopped;
+}
+
+void BaseOptimizer::set_async_mode(bool enabled, double timeout_seconds) {
+    if (enabled && !supports_async()) {
+        throw std::runtime_error("Asynchronous mode is not supported by this optimizer.");
+    }
+    if (timeout_seconds < 0.0) {
+        throw std::runtime_error("Timeout must be non-negative.");
+    }
+    async_mode = enabled;
+    async_timeout = timeout_seconds;
+}
+
+void BaseOptimizer::set_precision(Precision new_precision) {
+    if (new_precision == Precision::Float32 && !supports_float32()) {
+        throw std::runtime_error("Float32 mode is not supported by this optimizer.");
+    }
+    if (started || asked) {
+        throw std::runtime_error("Precision must be set before the initial population is evaluated.");
+    }
+    if (new_precision != precision) {
+        precision = new_precision;
+        precision_changed();
+        population_changed();
+    }
+}
+
+const Population& BaseOptimizer::widened(const Population32& population) const {
+    std::lock_guard<std::mutex> lock(widened_mutex);
+    if (!widened_current) {
+        widened_population.assign_from(population);
+        widened_current = true;
+    }
+    return widened_population;
+}
+
+void BaseOptimizer::population_changed() {
+    std::lock_guard<std::mutex> lock(widened_mutex);
+    widened_current = false;
+}
+
+int BaseOptimizer::propose_async(double* /*candidate*/) {
+    throw std::runtime_error("Asynchronous mode is not supported by this optimizer.");
+}
+
+void BaseOptimizer::accept_async(int /*slot*/, const double* /*candidate*/, double /*fitness*/) {
+    throw std::runtime_error("Asynchronous mode is not supported by this optimizer.");
+}
+
+void BaseOptimizer::export_migrants(int count, std::vector<double>& genomes, std::vector<double>& fitness) const {
+    const Population& population = get_population();
+    const std::vector<double>& values = get_fitness();
+    count = std::min(std::max(count, 0), population.rows());
+    std::vector<int> order(population.rows());
+    for (int i = 0; i < population.rows(); ++i) {
+        order[i] = i;
+    }
+    std::partial_sort(order.begin(), order.begin() + count, order.end(), [&](int a, int b) {
+        if (values[a] != values[b]) {
+            return minimize ? (values[a] < values[b]) : (values[a] > values[b]);
+        }
+        return a < b;
+    });
+    genomes.resize(static_cast<size_t>(count) * dim);
+    fitness.resize(count);
+    for (int k = 0; k < count; ++k) {
+        RowSpan<const double> row = population.row(order[k]);
+        std::copy(row.begin(), row.end(), genomes.begin() + static_cast<size_t>(k) * dim);
+        fitness[k] = values[order[k]];
+    }
+}
+
+void BaseOptimizer::import_migrants(const double* genomes, const double* fitness, int count) {
+    if (!started) {
+        throw std::runtime_error("Cannot import migrants before the initial population is evaluated.");
+    }
+    if (asked) {
+        throw std::runtime_error("Cannot import migrants while candidates are out for evaluation.");
+    }
+    for (int k = 0; k < count; ++k) {
+        replace_worst(genomes + static_cast<size_t>(k) * dim, fitness[k]);
+    }
+}
+
+bool BaseOptimizer::replace_worst(const double* genome, double fitness) {
+    const std::vector<double>& values = get_fitness();
+    int worst = 0;
+    for (int i = 1; i < num_individuals; ++i) {
+        if ((minimize && values[i] > values[worst]) || (!minimize && values[i] < values[worst])) {
+            worst = i;
+        }
+    }
+    if ((minimize && fitness < values[worst]) || (!minimize && fitness > values[worst])) {
+        replace_individual(worst, genome, fitness);
+        population_changed();
+        return true;
+    }
+    return false;
+}
+
+void BaseOptimizer::save_checkpoint(const std::string& path) const {
+    write_file_atomically(path, serialize());
+}
+
+void BaseOptimizer::load_checkpoint(const std::string& path) {
+    MappedFile file(path);
+    deserialize(file.data(), file.size());
+}
+
+std::vector<unsigned char> BaseOptimizer::serialize() const {
+    CheckpointHeader header;
+    header.algorithm = algorithm_name();
+    header.num_individuals = num_individuals;
+    header.dim = dim;
+    header.lower_bound = lower_bound;
+    header.upper_bound = upper_bound;
+    header.max_iter = max_iter;
+    CheckpointWriter out(header);
+
+    out.write(static_cast<uint8_t>(minimize));
+    out.write(static_cast<uint8_t>(verbose));
+    out.write(static_cast<uint8_t>(store_history_each_iter));
+    out.write(static_cast<uint8_t>(started));
+    out.write(static_cast<uint8_t>(asked));
+    out.write(static_cast<uint8_t>(async_mode));
+    out.write(static_cast<int32_t>(iteration));
+    out.write(static_cast<int32_t>(horizon));
+    out.write(rng_seed);
+    out.write(rng_step);
+    out.write(async_step);
+    out.write(async_timeout);
+    out.write(evaluation_count);
+    out.write(failed_evaluations);
+
+    out.write(termination.max_evaluations);
+    out.write(termination.max_seconds);
+    out.write(static_cast<uint8_t>(termination.has_target));
+    out.write(termination.target_fitness);
+    out.write(static_cast<int32_t>(termination.stagnation_window));
+    out.write(termination.stagnation_epsilon);
+    out.write(termination.min_diversity);
+    out.write(static_cast<int32_t>(stop_reason));
+    out.write(stagnation_best);
+    out.write(static_cast<int32_t>(stagnation_since));
+    out.write(static_cast<uint8_t>(precision));
+
+    fitness_cache.save(out);
+    surrogate.save(out);
+    save_state(out);
+    return std::move(out.finish());
+}
+
+void BaseOptimizer::deserialize(const unsigned char* data, std::size_t size) {
+    CheckpointReader in(data, size);
+    const CheckpointHeader& header = in.header();
+    if (header.algorithm != algorithm_name() || header.num_individuals != num_individuals || header.dim != dim) {
+        throw std::runtime_error("Checkpoint holds a " + header.algorithm + " with " +
+                                 std::to_string(header.num_individuals) + " individuals of dimension " +
+                                 std::to_string(header.dim) + "; it cannot be restored into this " +
+                                 algorithm_name() + ".");
+    }
+
+    // Everything is parsed and checked before any member changes, so a
+    // corrupt checkpoint leaves the optimizer as it was.
+    bool saved_minimize = in.read<uint8_t>() != 0;
+    bool saved_verbose = in.read<uint8_t>() != 0;
+    bool saved_store_history = in.read<uint8_t>() != 0;
+    bool saved_started = in.read<uint8_t>() != 0;
+    bool saved_asked = in.read<uint8_t>() != 0;
+    bool saved_async_mode = in.read<uint8_t>() != 0;
+    int saved_iteration = in.read<int32_t>();
+    int saved_horizon = in.read<int32_t>();
+    uint64_t saved_rng_seed = in.read<uint64_t>();
+    uint64_t saved_rng_step = in.read<uint64_t>();
+    uint64_t saved_async_step = in.read<uint64_t>();
+    double saved_async_timeout = in.read<double>();
+    uint64_t saved_evaluation_count = in.read<uint64_t>();
+    uint64_t saved_failed_evaluations = in.read<uint64_t>();
+
+    TerminationCriteria saved_termination;
+    saved_termination.max_evaluations = in.read<uint64_t>();
+    saved_termination.max_seconds = in.read<double>();
+    saved_termination.has_target = in.read<uint8_t>() != 0;
+    saved_termination.target_fitness = in.read<double>();
+    saved_termination.stagnation_window = in.read<int32_t>();
+    saved_termination.stagnation_epsilon = in.read<double>();
+    saved_termination.min_diversity = in.read<double>();
+    int32_t saved_stop_reason = in.read<int32_t>();
+    double saved_stagnation_best = in.read<double>();
+    int saved_stagnation_since = in.read<int32_t>();
+
+    if (header.max_iter < 0 || saved_iteration < 0 || saved_horizon < 0 || saved_stagnation_since < 0 ||
+        saved_stagnation_since > saved_iteration || saved_termination.stagnation_window < 0 ||
+        !(saved_async_timeout >= 0.0) || !(saved_termination.max_seconds >= 0.0) ||
+        saved_stop_reason < static_cast<int32_t>(StopReason::NotStopped) ||
+        saved_stop_reason > static_cast<int32_t>(StopReason::Callback)) {
+        throw std::runtime_error("Checkpoint is truncated or corrupt.");
+    }
+
+    // Checkpoints before version 3 are always float64.
+    Precision stored = Precision::Float64;
+    if (header.version >= 3) {
+        uint8_t value = in.read<uint8_t>();
+        if (value > static_cast<uint8_t>(Precision::Float32)) {
+            throw std::runtime_error("Checkpoint has an unknown precision.");
+        }
+        stored = static_cast<Precision>(value);
+    }
+    if (stored == Precision::Float32 && !supports_float32()) {
+        throw std::runtime_error("Checkpoint is in float32 mode, which this optimizer does not support.");
+    }
+
+    FitnessCache saved_cache;
+    saved_cache.load(in, dim);
+    // Checkpoints before version 4 have no surrogate.
+    Surrogate saved_surrogate;
+    if (header.version >= 4) {
+        saved_surrogate.load(in, dim);
+    } else {
+        saved_surrogate.configure(SurrogateSettings(), dim);
+    }
+
+    // The algorithm's own state is read straight into its members; should
+    // that fail, the state from before the call is put back.
+    std::vector<unsigned char> previous = serialize();
+    try {
+        lower_bound = header.lower_bound;
+        upper_bound = header.upper_bound;
+        max_iter = header.max_iter;
+        minimize = saved_minimize;
+        verbose = saved_verbose;
+        store_history_each_iter = saved_store_history;
+        started = saved_started;
+        asked = saved_asked;
+        async_mode = saved_async_mode;
+        iteration = saved_iteration;
+        horizon = saved_horizon;
+        rng_seed = saved_rng_seed;
+        rng_step = saved_rng_step;
+        async_step = saved_async_step;
+        async_timeout = saved_async_timeout;
+        evaluation_count = saved_evaluation_count;
+        failed_evaluations = saved_failed_evaluations;
+        termination = saved_termination;
+        stop_reason = static_cast<StopReason>(saved_stop_reason);
+        stagnation_best = saved_stagnation_best;
+        stagnation_since = saved_stagnation_since;
+        fitness_cache = std::move(saved_cache);
+        surrogate = std::move(saved_surrogate);
+        if (stored != precision) {
+            precision = stored;
+            precision_changed();
+        }
+        load_state(in);
+    } catch (...) {
+        deserialize(previous.data(), previous.size());
+        population_changed();
+        throw;
+    }
+    population_changed();
+}
@@ -0,0 +1,264 @@
+#include "surrogate.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Neighbours are ordered by distance, then by archive index (age).
+struct Neighbor {
+    double distance;
+    int index;
+    bool operator<(const Neighbor& other) const {
+        return distance != other.distance ? distance < other.distance : index < other.index;
+    }
+};
+
+// Bounded max-heap of the k nearest neighbours found so far.
+class NeighborSet {
+public:
+    explicit NeighborSet(int k) : k(k) { heap.reserve(k); }
+
+    void offer(double distance, int index) {
+        Neighbor candidate{distance, index};
+        if (static_cast<int>(heap.size()) < k) {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end());
+        } else if (candidate < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    // Distance up to which a point could still enter the set.
+    double limit() const {
+        return static_cast<int>(heap.size()) < k ? std::numeric_limits<double>::infinity() : heap.front().distance;
+    }
+
+    std::vector<Neighbor>& sorted() {
+        std::sort_heap(heap.begin(), heap.end());
+        return heap;
+    }
+
+private:
+    int k;
+    std::vector<Neighbor> heap;
+};
+
+// Squared distance, abandoned once it exceeds `limit` (the result is then
+// some value above `limit`).
+double squared_distance(const double* a, const double* b, int dim, double limit) {
+    double sum = 0.0;
+    int d = 0;
+    for (; d + 4 <= dim; d += 4) {
+        double d0 = a[d] - b[d];
+        double d1 = a[d + 1] - b[d + 1];
+        double d2 = a[d + 2] - b[d + 2];
+        double d3 = a[d + 3] - b[d + 3];
+        sum += d0 * d0;
+        sum += d1 * d1;
+        sum += d2 * d2;
+        sum += d3 * d3;
+        if (sum > limit) {
+            return sum;
+        }
+    }
+    for (; d < dim; ++d) {
+        double diff = a[d] - b[d];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+void check_settings(const SurrogateSettings& settings) {
+    if (settings.neighbors < 1) {
+        throw std::runtime_error("Surrogate needs at least one neighbor.");
+    }
+    if (!(settings.evaluate_fraction >= 0.0 && settings.evaluate_fraction <= 1.0) ||
+        !(settings.explore_fraction >= 0.0 && settings.explore_fraction <= 1.0)) {
+        throw std::runtime_error("Surrogate fractions must lie in [0, 1].");
+    }
+}
+
+}  // namespace
+
+void Surrogate::configure(const SurrogateSettings& new_settings, int new_dim) {
+    check_settings(new_settings);
+    settings = new_settings;
+    settings.capacity = std::max(settings.capacity, 0);
+    dim = new_dim;
+    screened = 0;
+    genomes.clear();
+    values.clear();
+    genomes.reserve(static_cast<std::size_t>(settings.capacity) * dim);
+    values.reserve(settings.capacity);
+    rebuild();
+}
+
+bool Surrogate::ready() const {
+    return enabled() && size() >= std::max(settings.min_points, settings.neighbors);
+}
+
+struct Surrogate::Query {
+    const double* x;
+    NeighborSet nearest;
+    std::vector<double> offsets;  // Per dimension, distance from x to the current cell.
+};
+
+double Surrogate::predict(const double* x) const {
+    Query query{x, NeighborSet(std::min(settings.neighbors, size())), std::vector<double>(dim, 0.0)};
+    search(0, indexed, 0.0, query);
+    NeighborSet& nearest = query.nearest;
+    for (int i = indexed; i < size(); ++i) {
+        nearest.offer(squared_distance(x, genome(i), dim, nearest.limit()), i);
+    }
+
+    const std::vector<Neighbor>& found = nearest.sorted();
+    if (found.empty()) {
+        return 0.0;
+    }
+    if (found[0].distance == 0.0) {
+        // Archived genomes at x: their mean, in case the objective is noisy.
+        double sum = 0.0;
+        int matches = 0;
+        for (const Neighbor& n : found) {
+            if (n.distance != 0.0) {
+                break;
+            }
+            sum += values[n.index];
+            ++matches;
+        }
+        return sum / matches;
+    }
+    double weighted = 0.0;
+    double total = 0.0;
+    for (const Neighbor& n : found) {
+        double weight = 1.0 / n.distance;
+        weighted += weight * values[n.index];
+        total += weight;
+    }
+    return weighted / total;
+}
+
+void Surrogate::insert(const double* x, double fitness) {
+    if (!enabled() || !std::isfinite(fitness)) {
+        return;
+    }
+    if (size() == settings.capacity) {
+        int drop = std::max(settings.capacity / 4, 1);
+        genomes.erase(genomes.begin(), genomes.begin() + static_cast<std::size_t>(drop) * dim);
+        values.erase(values.begin(), values.begin() + drop);
+        indexed = 0;
+    }
+    genomes.insert(genomes.end(), x, x + dim);
+    values.push_back(fitness);
+    if (size() - indexed > std::max(16, indexed / 4)) {
+        rebuild();
+    }
+}
+
+// Nearer side first; the far side is visited only when its cell, at squared
+// distance `bound` (Arya and Mount's incremental bound), is within the
+// current k-th distance.
+void Surrogate::search(int lo, int hi, double bound, Query& query) const {
+    if (hi - lo <= LEAF_SIZE) {
+        for (int k = lo; k < hi; ++k) {
+            int i = tree_order[k];
+            query.nearest.offer(squared_distance(query.x, genome(i), dim, query.nearest.limit()), i);
+        }
+        return;
+    }
+    int mid = (lo + hi) / 2;
+    int d = split_dim[mid];
+    double diff = query.x[d] - split_value[mid];
+    bool lower_first = diff < 0.0;
+    search(lower_first ? lo : mid, lower_first ? mid : hi, bound, query);
+    double old = query.offsets[d];
+    double far_bound = bound - old * old + diff * diff;
+    if (far_bound <= query.nearest.limit()) {
+        query.offsets[d] = diff;
+        search(lower_first ? mid : lo, lower_first ? hi : mid, far_bound, query);
+        query.offsets[d] = old;
+    }
+}
+
+void Surrogate::rebuild() {
+    // A k-d tree only prunes with many more genomes than 2^dim; below that
+    // queries scan the whole archive.
+    indexed = (dim < 31 && (1 << dim) <= size()) ? size() : 0;
+    tree_order.resize(indexed);
+    std::iota(tree_order.begin(), tree_order.end(), 0);
+    split_dim.assign(indexed, 0);
+    split_value.assign(indexed, 0.0);
+    build(0, indexed);
+}
+
+void Surrogate::build(int lo, int hi) {
+    if (hi - lo <= LEAF_SIZE) {
+        return;
+    }
+    // Split along the dimension with the widest spread.
+    int best_dim = 0;
+    double best_spread = -1.0;
+    for (int d = 0; d < dim; ++d) {
+        double low = genome(tree_order[lo])[d];
+        double high = low;
+        for (int k = lo + 1; k < hi; ++k) {
+            double v = genome(tree_order[k])[d];
+            low = std::min(low, v);
+            high = std::max(high, v);
+        }
+        if (high - low > best_spread) {
+            best_spread = high - low;
+            best_dim = d;
+        }
+    }
+    int mid = (lo + hi) / 2;
+    std::nth_element(tree_order.begin() + lo, tree_order.begin() + mid, tree_order.begin() + hi,
+                     [&](int a, int b) { return genome(a)[best_dim] < genome(b)[best_dim]; });
+    split_dim[mid] = best_dim;
+    split_value[mid] = genome(tree_order[mid])[best_dim];
+    build(lo, mid);
+    build(mid, hi);
+}
+
+void Surrogate::save(CheckpointWriter& out) const {
+    out.write(static_cast<int32_t>(settings.capacity));
+    out.write(static_cast<int32_t>(settings.neighbors));
+    out.write(settings.evaluate_fraction);
+    out.write(settings.explore_fraction);
+    out.write(static_cast<int32_t>(settings.min_points));
+    out.write(screened);
+    out.write_array(values);
+    out.write_array(genomes);
+}
+
+void Surrogate::load(CheckpointReader& in, int new_dim) {
+    SurrogateSettings saved;
+    saved.capacity = in.read<int32_t>();
+    saved.neighbors = in.read<int32_t>();
+    saved.evaluate_fraction = in.read<double>();
+    saved.explore_fraction = in.read<double>();
+    saved.min_points = in.read<int32_t>();
+    check_settings(saved);
+    uint64_t saved_screened = in.read<uint64_t>();
+    // The archive is sized from what was saved, not reserved up to the
+    // saved capacity, so a corrupt capacity cannot force a huge allocation.
+    std::vector<double> saved_values = in.read_vector<double>();
+    if (saved.capacity < 0 || saved_values.size() > static_cast<std::size_t>(saved.capacity) ||
+        saved_values.size() > in.remaining() / (sizeof(double) * new_dim)) {
+        throw std::runtime_error("Checkpoint is truncated or corrupt.");
+    }
+    std::vector<double> saved_genomes(saved_values.size() * new_dim);
+    in.read_into(saved_genomes);
+    settings = saved;
+    dim = new_dim;
+    screened = saved_screened;
+    values = std::move(saved_values);
+    genomes = std::move(saved_genomes);
+    rebuild();
+}
@@ -0,0 +1,60 @@
+#include "termination.h"
+#include <cmath>
+#include <vector>
+
+const char* stop_reason_name(StopReason reason) {
+    switch (reason) {
+        case StopReason::NotStopped: return "not_stopped";
+        case StopReason::MaxIterations: return "max_iterations";
+        case StopReason::MaxEvaluations: return "max_evaluations";
+        case StopReason::Deadline: return "deadline";
+        case StopReason::TargetReached: return "target_reached";
+        case StopReason::Stagnation: return "stagnation";
+        case StopReason::DiversityCollapse: return "diversity_collapse";
+        case StopReason::Callback: return "callback";
+    }
+    return "unknown";
+}
+
+// Accumulates in double for either storage type.
+template <typename T>
+static double diversity_of(const BasicPopulation<T>& population, double lower_bound, double upper_bound) {
+    int n = population.rows();
+    int dim = population.cols();
+    if (n < 2 || dim == 0) {
+        return 0.0;
+    }
+    // Row-major passes over contiguous rows: column sums, then squared deviations.
+    std::vector<double> mean(dim, 0.0);
+    for (int i = 0; i < n; ++i) {
+        RowSpan<const T> row = population.row(i);
+        for (int d = 0; d < dim; ++d) {
+            mean[d] += row[d];
+        }
+    }
+    for (int d = 0; d < dim; ++d) {
+        mean[d] /= n;
+    }
+    std::vector<double> variance(dim, 0.0);
+    for (int i = 0; i < n; ++i) {
+        RowSpan<const T> row = population.row(i);
+        for (int d = 0; d < dim; ++d) {
+            double delta = row[d] - mean[d];
+            variance[d] += delta * delta;
+        }
+    }
+    double total = 0.0;
+    for (int d = 0; d < dim; ++d) {
+        total += std::sqrt(variance[d] / n);
+    }
+    double range = upper_bound - lower_bound;
+    return range > 0.0 ? total / dim / range : 0.0;
+}
+
+double population_diversity(const Population& population, double lower_bound, double upper_bound) {
+    return diversity_of(population, lower_bound, upper_bound);
+}
+
+double population_diversity(const Population32& population, double lower_bound, double upper_bound) {
+    return diversity_of(population, lower_bound, upper_bound);
+}
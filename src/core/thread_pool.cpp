@@ -0,0 +1,99 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int num_threads) {
+    if (num_threads <= 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(num_threads - 1);
+    for (int t = 1; t < num_threads; ++t) {
+        workers.emplace_back(&ThreadPool::worker_loop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    job_ready.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallel_for(int count, int chunk_size, const std::function<void(int, int)>& body) {
+    if (count <= 0) {
+        return;
+    }
+    if (chunk_size <= 0) {
+        // A few chunks per thread keeps the load balanced without much contention.
+        chunk_size = std::max(1, count / (size() * 4));
+    }
+    if (workers.empty() || count <= chunk_size) {
+        body(0, count);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job_body = &body;
+        job_count = count;
+        job_chunk = chunk_size;
+        job_error = nullptr;
+        next_index.store(0, std::memory_order_relaxed);
+        active_workers = static_cast<int>(workers.size());
+        ++job_id;
+    }
+    job_ready.notify_all();
+    run_chunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    job_done.wait(lock, [this] { return active_workers == 0; });
+    job_body = nullptr;
+    if (job_error) {
+        std::exception_ptr error = job_error;
+        job_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::worker_loop() {
+    unsigned long seen_job = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            job_ready.wait(lock, [&] { return stopping || job_id != seen_job; });
+            if (stopping) {
+                return;
+            }
+            seen_job = job_id;
+        }
+        run_chunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--active_workers == 0) {
+                job_done.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::run_chunks() {
+    for (;;) {
+        int begin = next_index.fetch_add(job_chunk, std::memory_order_relaxed);
+        if (begin >= job_count) {
+            return;
+        }
+        int end = std::min(begin + job_chunk, job_count);
+        try {
+            (*job_body)(begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!job_error) {
+                job_error = std::current_exception();
+            }
+            // Skip the remaining chunks.
+            next_index.store(job_count, std::memory_order_relaxed);
+        }
+    }
+}
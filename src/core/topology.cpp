@@ -0,0 +1,193 @@
+#include "topology.h"
+#include "random_stream.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// Random stream lane of the random topologies, apart from the PSO update lanes.
+const uint32_t TOPOLOGY_LANE = 3;
+
+// Whether particle a's personal best ranks before particle b's: by fitness,
+// NaN last, and by index on ties, so the incremental and full updates agree.
+bool ranks_before(int a, int b, const std::vector<double>& fitness, bool minimize) {
+    double fa = fitness[a];
+    double fb = fitness[b];
+    if (std::isnan(fa) || std::isnan(fb)) {
+        return std::isnan(fa) == std::isnan(fb) ? a < b : std::isnan(fb);
+    }
+    if (fa != fb) {
+        return minimize ? fa < fb : fa > fb;
+    }
+    return a < b;
+}
+
+// Appends rows of a CSR graph, skipping repeated entries within a row.
+class RowBuilder {
+public:
+    RowBuilder(int n, std::vector<int>& offsets, std::vector<int>& index)
+        : seen(n, -1), offsets(offsets), index(index), row(0) {
+        offsets.assign(1, 0);
+        index.clear();
+    }
+
+    void add(int j) {
+        if (seen[j] != row) {
+            seen[j] = row;
+            index.push_back(j);
+        }
+    }
+
+    void end_row() {
+        offsets.push_back(static_cast<int>(index.size()));
+        ++row;
+    }
+
+private:
+    std::vector<int> seen;
+    std::vector<int>& offsets;
+    std::vector<int>& index;
+    int row;
+};
+
+// Transpose of an n-row CSR graph; rows of the result list sources in ascending order.
+void transpose(int n, const std::vector<int>& offsets, const std::vector<int>& index,
+               std::vector<int>& out_offsets, std::vector<int>& out_index) {
+    out_offsets.assign(n + 1, 0);
+    for (int j : index) {
+        ++out_offsets[j + 1];
+    }
+    for (int i = 0; i < n; ++i) {
+        out_offsets[i + 1] += out_offsets[i];
+    }
+    out_index.resize(index.size());
+    std::vector<int> fill(out_offsets.begin(), out_offsets.end() - 1);
+    for (int i = 0; i < n; ++i) {
+        for (int e = offsets[i]; e < offsets[i + 1]; ++e) {
+            out_index[fill[index[e]]++] = i;
+        }
+    }
+}
+
+}  // namespace
+
+const char* topology_name(TopologyKind kind) {
+    switch (kind) {
+        case TopologyKind::Global: return "global";
+        case TopologyKind::Ring: return "ring";
+        case TopologyKind::VonNeumann: return "von_neumann";
+        case TopologyKind::RandomRegular: return "random_regular";
+        case TopologyKind::Dynamic: return "dynamic";
+    }
+    return "unknown";
+}
+
+int max_neighbor_size(TopologyKind kind, int n) {
+    switch (kind) {
+        case TopologyKind::Ring:
+        case TopologyKind::RandomRegular: return std::max(n / 2, 1);
+        case TopologyKind::Dynamic: return std::max(n - 1, 1);
+        default: return std::numeric_limits<int>::max();
+    }
+}
+
+void Topology::build(TopologyKind topology_kind, int n, int neighbor_size, uint64_t seed, uint64_t epoch) {
+    kind = topology_kind;
+    local_best.resize(n);
+    for (int i = 0; i < n; ++i) {
+        local_best[i] = i;
+    }
+    if (kind == TopologyKind::Global || n == 0) {
+        offsets.assign(n + 1, 0);
+        neighbor_index.clear();
+        informed_offsets.assign(n + 1, 0);
+        informed_index.clear();
+        return;
+    }
+    int k = std::min(std::max(neighbor_size, 0), max_neighbor_size(kind, n));
+
+    if (kind == TopologyKind::Dynamic) {
+        // Each particle informs itself and k random particles; a particle's
+        // neighbors are those that inform it.
+        RowBuilder informs(n, informed_offsets, informed_index);
+        for (int i = 0; i < n; ++i) {
+            RandomStream stream(seed, epoch, i, TOPOLOGY_LANE);
+            informs.add(i);
+            for (int c = 0; c < k; ++c) {
+                informs.add(stream.uniform_int(0, n - 1));
+            }
+            informs.end_row();
+        }
+        transpose(n, informed_offsets, informed_index, offsets, neighbor_index);
+        return;
+    }
+
+    // Position of each particle on the ring (a random order for RandomRegular).
+    std::vector<int> order(n);
+    for (int i = 0; i < n; ++i) {
+        order[i] = i;
+    }
+    if (kind == TopologyKind::RandomRegular) {
+        RandomStream stream(seed, epoch, 0, TOPOLOGY_LANE);
+        for (int i = n - 1; i > 0; --i) {
+            std::swap(order[i], order[stream.uniform_int(0, i)]);
+        }
+    }
+    std::vector<int> slot(n);
+    for (int p = 0; p < n; ++p) {
+        slot[order[p]] = p;
+    }
+
+    RowBuilder rows(n, offsets, neighbor_index);
+    int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n))));
+    for (int i = 0; i < n; ++i) {
+        if (kind == TopologyKind::VonNeumann) {
+            // Wrapped grid on the linear index: left, self, right, up, down.
+            rows.add((i - 1 + n) % n);
+            rows.add(i);
+            rows.add((i + 1) % n);
+            rows.add(((i - columns) % n + n) % n);
+            rows.add((i + columns) % n);
+        } else {
+            // Ring and RandomRegular: neighbors in offset order -k..k, as the
+            // original ring scan visited them.
+            int p = slot[i];
+            for (int offset = -k; offset <= k; ++offset) {
+                rows.add(order[((p + offset) % n + n) % n]);
+            }
+        }
+        rows.end_row();
+    }
+    transpose(n, offsets, neighbor_index, informed_offsets, informed_index);
+}
+
+void Topology::reset_bests(const std::vector<double>& fitness, bool minimize) {
+    if (is_global()) {
+        return;
+    }
+    int n = static_cast<int>(local_best.size());
+    for (int i = 0; i < n; ++i) {
+        int best_idx = i;
+        for (int e = offsets[i]; e < offsets[i + 1]; ++e) {
+            int j = neighbor_index[e];
+            if (ranks_before(j, best_idx, fitness, minimize)) {
+                best_idx = j;
+            }
+        }
+        local_best[i] = best_idx;
+    }
+}
+
+void Topology::improved(int i, const std::vector<double>& fitness, bool minimize) {
+    if (is_global()) {
+        return;
+    }
+    for (int e = informed_offsets[i]; e < informed_offsets[i + 1]; ++e) {
+        int j = informed_index[e];
+        if (ranks_before(i, local_best[j], fitness, minimize)) {
+            local_best[j] = i;
+        }
+    }
+}
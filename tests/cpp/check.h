@@ -0,0 +1,53 @@
+#ifndef BIOOPT_TEST_CHECK_H
+#define BIOOPT_TEST_CHECK_H
+
+#include "base_optimizer.h"
+#include <cstdio>
+#include <vector>
+
+// Minimal checks for the C++ regression tests: a failed CHECK prints its
+// location and makes test_result() non-zero, but the test keeps running.
+// Also the objective and ask()/tell() helpers the tests share.
+
+static int check_failures = 0;
+
+#define CHECK(condition)                                                         \
+    do {                                                                         \
+        if (!(condition)) {                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+                         #condition);                                            \
+            ++check_failures;                                                    \
+        }                                                                        \
+    } while (0)
+
+static inline int test_result() {
+    if (check_failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", check_failures);
+        return 1;
+    }
+    return 0;
+}
+
+static inline double sphere(const std::vector<double>& x) {
+    double sum = 0.0;
+    for (double v : x) {
+        sum += v * v;
+    }
+    return sum;
+}
+
+// Fitness of every candidate row.
+static inline std::vector<double> evaluate_all(const Population& candidates) {
+    std::vector<double> fitness(candidates.rows());
+    for (int i = 0; i < candidates.rows(); ++i) {
+        fitness[i] = sphere(candidates.row_vector(i));
+    }
+    return fitness;
+}
+
+// One ask()/tell() iteration on the sphere.
+static inline void step(BaseOptimizer& optimizer) {
+    optimizer.tell(evaluate_all(optimizer.ask()));
+}
+
+#endif // BIOOPT_TEST_CHECK_H
@@ -0,0 +1,101 @@
+// Asynchronous mode with a timeout: optimize() must return while timed-out
+// evaluations are still running, even when more of them hang than there are
+// workers. The optimizer keeps their threads and waits for them at the start
+// of the next run or when it is destroyed.
+
+#include "check.h"
+#include "pso.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Calls [skip, skip + hanging) block until release() is called.
+struct Gate {
+    std::mutex mutex;
+    std::condition_variable opened;
+    bool open = false;
+    std::atomic<int> calls{0};
+    std::atomic<int> entered{0};
+    std::atomic<int> returned{0};
+    int skip = 0;
+    int hanging = 0;
+
+    double evaluate(const std::vector<double>& x) {
+        int call = calls.fetch_add(1);
+        if (call >= skip && call < skip + hanging) {
+            ++entered;
+            std::unique_lock<std::mutex> lock(mutex);
+            opened.wait(lock, [&] { return open; });
+            ++returned;
+        }
+        return sphere(x);
+    }
+
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            open = true;
+        }
+        opened.notify_all();
+    }
+};
+
+// Releases the gate after a delay, from another thread.
+std::thread release_later(std::shared_ptr<Gate> gate) {
+    return std::thread([gate] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        gate->release();
+    });
+}
+
+// The initial population is evaluated synchronously. After it, hanging
+// calls leave both workers and both spares stuck, so the remaining
+// candidates time out in the queue.
+std::unique_ptr<PSO> run_with_stragglers(std::shared_ptr<Gate> gate) {
+    using Clock = std::chrono::steady_clock;
+    gate->skip = 8;
+    gate->hanging = 6;
+    std::unique_ptr<PSO> pso(new PSO(8, 3, -5.0, 5.0, 10, 1.5, 1.5, 0.7));
+    pso->set_objective([gate](const std::vector<double>& x) { return gate->evaluate(x); }, true);
+    pso->set_num_threads(2);
+    pso->set_async_mode(true, 0.05);
+
+    Clock::time_point start = Clock::now();
+    pso->optimize(3);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    CHECK(seconds < 5.0);
+    CHECK(pso->get_iteration() == 3);
+    CHECK(pso->get_failed_evaluations() >= 6);
+    CHECK(gate->entered.load() == 4);
+    CHECK(gate->returned.load() == 0);
+    return pso;
+}
+
+}  // namespace
+
+int main() {
+    // The next run waits for the stragglers before evaluating anything.
+    auto gate = std::make_shared<Gate>();
+    std::unique_ptr<PSO> pso = run_with_stragglers(gate);
+    std::thread opener = release_later(gate);
+    pso->set_async_mode(false);
+    pso->optimize(1);
+    CHECK(gate->returned.load() == gate->entered.load());
+    CHECK(pso->get_iteration() == 4);
+    opener.join();
+
+    // So does the destructor.
+    gate = std::make_shared<Gate>();
+    pso = run_with_stragglers(gate);
+    opener = release_later(gate);
+    pso.reset();
+    CHECK(gate->returned.load() == gate->entered.load());
+    opener.join();
+    return test_result();
+}
@@ -0,0 +1,112 @@
+/*
+ * The C interface, compiled as C: NULL handles give the documented
+ * sentinels instead of crashing, settings structs are checked by
+ * struct_size, and ask/tell evaluates only the candidate rows.
+ */
+
+#include "bioopt_c.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+
+static int check_failures = 0;
+
+#define CHECK(condition)                                                                     \
+    do {                                                                                     \
+        if (!(condition)) {                                                                  \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);    \
+            ++check_failures;                                                                \
+        }                                                                                    \
+    } while (0)
+
+static double sphere(const double* x, size_t dim, void* user_data) {
+    double sum = 0.0;
+    size_t d;
+    (void)user_data;
+    for (d = 0; d < dim; ++d) {
+        sum += x[d] * x[d];
+    }
+    return sum;
+}
+
+int main(void) {
+    bioopt_optimizer* optimizer;
+    bioopt_termination criteria = {0};
+    bioopt_surrogate surrogate = {0};
+    double best[4];
+    const double* positions;
+    const int* fresh;
+    double fitness[10];
+    uint64_t evaluations = 0;
+    int rows, cols, count, step, i;
+
+    CHECK(isnan(bioopt_get_best_fitness(NULL)));
+    CHECK(bioopt_get_iteration(NULL) == BIOOPT_ERROR);
+    CHECK(bioopt_get_evaluation_count(NULL) == UINT64_MAX);
+    CHECK(bioopt_get_evaluations_saved(NULL) == UINT64_MAX);
+    CHECK(bioopt_get_stop_reason(NULL) == BIOOPT_ERROR);
+    CHECK(bioopt_get_best_solution(NULL, best, 4) == BIOOPT_ERROR);
+    CHECK(bioopt_last_error()[0] != '\0');
+
+    optimizer = bioopt_pso_create(16, 4, -5.0, 5.0, 20, 1.5, 1.5, 0.7, 1, 7);
+    CHECK(optimizer != NULL);
+    CHECK(bioopt_set_objective(optimizer, sphere, NULL, 1) == BIOOPT_OK);
+
+    /* struct_size left at zero or short of the last field is rejected;
+     * anything from the end of the last field up, including a larger
+     * struct from a newer header, is accepted. */
+    criteria.max_evaluations = 160;
+    CHECK(bioopt_set_termination(optimizer, &criteria) == BIOOPT_ERROR);
+    criteria.struct_size = offsetof(bioopt_termination, min_diversity);
+    CHECK(bioopt_set_termination(optimizer, &criteria) == BIOOPT_ERROR);
+    criteria.struct_size = sizeof(criteria) + 32;
+    CHECK(bioopt_set_termination(optimizer, &criteria) == BIOOPT_OK);
+    criteria.struct_size = sizeof(criteria);
+    CHECK(bioopt_set_termination(optimizer, &criteria) == BIOOPT_OK);
+    surrogate.capacity = 64;
+    surrogate.neighbors = 4;
+    surrogate.evaluate_fraction = 0.5;
+    surrogate.min_points = 8;
+    CHECK(bioopt_set_surrogate(optimizer, &surrogate) == BIOOPT_ERROR);
+    surrogate.struct_size = offsetof(bioopt_surrogate, min_points) + sizeof(int) - 1;
+    CHECK(bioopt_set_surrogate(optimizer, &surrogate) == BIOOPT_ERROR);
+    surrogate.struct_size = offsetof(bioopt_surrogate, min_points) + sizeof(int);
+    CHECK(bioopt_set_surrogate(optimizer, &surrogate) == BIOOPT_OK);
+    surrogate.struct_size = sizeof(surrogate) + 32;
+    CHECK(bioopt_set_surrogate(optimizer, &surrogate) == BIOOPT_OK);
+
+    CHECK(bioopt_optimize(optimizer, -1) == BIOOPT_OK);
+    CHECK(bioopt_get_stop_reason(optimizer) == BIOOPT_STOP_MAX_EVALUATIONS);
+    CHECK(bioopt_get_evaluation_count(optimizer) >= 160);
+    CHECK(bioopt_get_iteration(optimizer) > 0);
+    CHECK(bioopt_get_best_solution(optimizer, best, 4) == BIOOPT_OK);
+    CHECK(bioopt_get_best_fitness(optimizer) == sphere(best, 4, NULL));
+    bioopt_destroy(optimizer);
+
+    /* GA elites are carried over: only the candidate rows are evaluated. */
+    optimizer = bioopt_ga_create(10, 4, -5.0, 5.0, 20, 0.7, 0.2, 1, 7);
+    CHECK(optimizer != NULL);
+    for (step = 0; step < 3; ++step) {
+        CHECK(bioopt_ask(optimizer, &positions, &rows, &cols) == BIOOPT_OK);
+        CHECK(bioopt_get_candidate_rows(optimizer, &fresh, &count) == BIOOPT_OK);
+        CHECK(count > 0 && count <= rows && rows <= 10);
+        for (i = 0; i < rows; ++i) {
+            fitness[i] = NAN;
+        }
+        for (i = 0; i < count; ++i) {
+            fitness[fresh[i]] = sphere(positions + fresh[i] * cols, (size_t)cols, NULL);
+        }
+        evaluations += (uint64_t)count;
+        CHECK(bioopt_tell(optimizer, fitness, rows) == BIOOPT_OK);
+    }
+    CHECK(count < rows);
+    CHECK(bioopt_get_evaluation_count(optimizer) == evaluations);
+    CHECK(!isnan(bioopt_get_best_fitness(optimizer)));
+    bioopt_destroy(optimizer);
+
+    if (check_failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", check_failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// A checkpoint is restored all or nothing: a corrupt or truncated one throws
+// and leaves the optimizer exactly as it was. Saving replaces the previous
+// file without leaving the temporary behind.
+
+#include "check.h"
+#include "pso.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Payload length in the 64-byte header, and the stop reason in the payload;
+// main() checks the values found there before patching them. Other fields
+// are located by changing them and comparing checkpoints.
+const std::size_t PAYLOAD_AT = 56;
+const std::size_t STOP_REASON_AT = 64 + 107;
+
+std::unique_ptr<PSO> make_pso(int iterations) {
+    std::unique_ptr<PSO> pso(new PSO(16, 4, -5.0, 5.0, 20, 1.5, 1.5, 0.7));
+    pso->set_objective(sphere);
+    pso->set_topology(TopologyKind::Ring, 1);
+    pso->set_fitness_cache(32);
+    pso->optimize(iterations);
+    return pso;
+}
+
+template <typename T>
+T read_at(const std::vector<unsigned char>& bytes, std::size_t at) {
+    T value;
+    std::memcpy(&value, bytes.data() + at, sizeof(T));
+    return value;
+}
+
+// First payload byte at which two checkpoints differ.
+std::size_t first_difference(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b) {
+    std::size_t at = 64;
+    while (at < a.size() && at < b.size() && a[at] == b[at]) {
+        ++at;
+    }
+    return at;
+}
+
+template <typename T>
+std::vector<unsigned char> patched(std::vector<unsigned char> bytes, std::size_t at, T value) {
+    std::memcpy(bytes.data() + at, &value, sizeof(T));
+    return bytes;
+}
+
+// Drops the last `count` payload bytes and shortens the header to match,
+// so the reader fails partway through the algorithm's own state.
+std::vector<unsigned char> truncated(std::vector<unsigned char> bytes, std::size_t count) {
+    bytes.resize(bytes.size() - count);
+    return patched(bytes, PAYLOAD_AT, read_at<uint64_t>(bytes, PAYLOAD_AT) - count);
+}
+
+bool rejected(BaseOptimizer& optimizer, const std::vector<unsigned char>& bytes) {
+    try {
+        optimizer.deserialize(bytes.data(), bytes.size());
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+int main() {
+    std::unique_ptr<PSO> source = make_pso(2);
+    std::vector<unsigned char> checkpoint = source->serialize();
+    CHECK(read_at<uint64_t>(checkpoint, PAYLOAD_AT) == checkpoint.size() - 64);
+    CHECK(read_at<int32_t>(checkpoint, STOP_REASON_AT) == static_cast<int32_t>(source->get_stop_reason()));
+
+    // Resizing an emptied cache changes only its capacity; widening the
+    // ring changes only the neighbor size.
+    std::unique_ptr<PSO> resized = make_pso(2);
+    resized->set_fitness_cache(32);
+    std::vector<unsigned char> small_cache = resized->serialize();
+    resized->set_fitness_cache(33);
+    std::size_t cache_capacity_at = first_difference(small_cache, resized->serialize());
+    CHECK(read_at<int32_t>(small_cache, cache_capacity_at) == 32);
+    source->set_topology(TopologyKind::Ring, 2);
+    std::size_t neighbor_size_at = first_difference(checkpoint, source->serialize());
+    CHECK(read_at<int32_t>(checkpoint, neighbor_size_at) == 1);
+
+    std::unique_ptr<PSO> owner = make_pso(5);
+    PSO& target = *owner;
+    std::vector<unsigned char> before = target.serialize();
+    CHECK(before != checkpoint);
+
+    CHECK(rejected(target, patched<int32_t>(checkpoint, STOP_REASON_AT, 8)));
+    CHECK(rejected(target, patched<int32_t>(checkpoint, STOP_REASON_AT, -1)));
+    CHECK(target.serialize() == before);
+
+    CHECK(rejected(target, patched<int32_t>(small_cache, cache_capacity_at, 1 << 30)));
+    CHECK(target.serialize() == before);
+
+    CHECK(rejected(target, patched<int32_t>(checkpoint, neighbor_size_at, INT32_MAX)));
+    CHECK(rejected(target, patched<int32_t>(checkpoint, neighbor_size_at, -1)));
+    CHECK(target.serialize() == before);
+
+    CHECK(rejected(target, truncated(checkpoint, 24)));
+    CHECK(target.serialize() == before);
+    CHECK(target.get_iteration() == 5);
+
+    target.deserialize(checkpoint.data(), checkpoint.size());
+    CHECK(target.serialize() == checkpoint);
+
+    std::string path = "test_checkpoint.bin";
+    target.save_checkpoint(path);
+    make_pso(3)->save_checkpoint(path);
+    CHECK(!std::ifstream(path + ".tmp"));
+    target.load_checkpoint(path);
+    CHECK(target.get_iteration() == 3);
+    std::remove(path.c_str());
+    return test_result();
+}
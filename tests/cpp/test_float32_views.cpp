@@ -0,0 +1,69 @@
+// In float32 mode get_population() hands out a widened double copy. It must
+// be refreshed once per change, not on every call, so references held by
+// one caller are not rewritten under them by another, and must always
+// match the float32 population.
+
+#include "check.h"
+#include "pso.h"
+#include "sma.h"
+#include <thread>
+#include <vector>
+
+namespace {
+
+bool matches_narrow(const BaseOptimizer& optimizer, const Population& wide) {
+    const Population32& narrow = *optimizer.get_population32();
+    for (std::size_t k = 0; k < narrow.size(); ++k) {
+        if (wide.data()[k] != static_cast<double>(narrow.data()[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    PSO pso(32, 6, -5.0, 5.0, 20, 1.5, 1.5, 0.7);
+    pso.set_objective(sphere);
+    pso.set_precision(Precision::Float32);
+
+    const Population& held = pso.get_population();
+    CHECK(matches_narrow(pso, held));
+    for (int k = 0; k < 5; ++k) {
+        step(pso);
+        // Still the same buffer, refreshed on the next get_population().
+        const Population& current = pso.get_population();
+        CHECK(&current == &held);
+        CHECK(matches_narrow(pso, held));
+    }
+
+    pso.optimize(3);
+    // Several readers after a change: one refresh, the same values for all.
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t] {
+            for (int k = 0; k < 200; ++k) {
+                mismatches[t] += matches_narrow(pso, pso.get_population()) ? 0 : 1;
+            }
+        });
+    }
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    for (int count : mismatches) {
+        CHECK(count == 0);
+    }
+
+    // SMA::update_positions() moves the population outside a step.
+    SMA sma(32, 6, -5.0, 5.0, 20, 0.5, 0.5, 0.9);
+    sma.set_objective(sphere);
+    sma.set_precision(Precision::Float32);
+    const Population& before = sma.get_population();
+    std::vector<double> first = before.row_vector(0);
+    sma.update_positions(0);
+    CHECK(matches_narrow(sma, sma.get_population()));
+    CHECK(sma.get_population().row_vector(0) != first);
+    return test_result();
+}
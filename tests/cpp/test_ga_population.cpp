@@ -0,0 +1,90 @@
+// GA breeds into a back buffer and swaps it in; the storage behind
+// get_population() must still be the same whenever the population is
+// handed out: by ask(), in progress callbacks and after optimize(). Told
+// values of carried rows are ignored.
+
+#include "check.h"
+#include "ga.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace {
+
+std::unique_ptr<GA> make_ga() {
+    std::unique_ptr<GA> ga(new GA(20, 5, -5.0, 5.0, 10, true, false, 7, 0.7, 0.2));
+    ga->set_objective(sphere);
+    return ga;
+}
+
+}  // namespace
+
+int main() {
+    {
+        std::unique_ptr<GA> owner = make_ga();
+        GA& ga = *owner;
+        const double* storage = ga.get_population().data();
+        for (int k = 0; k < 7; ++k) {
+            const Population& candidates = ga.ask();
+            CHECK(candidates.data() == storage);
+            ga.tell(evaluate_all(candidates));
+            CHECK(ga.get_population().data() == storage);
+        }
+    }
+    {
+        std::unique_ptr<GA> owner = make_ga();
+        GA& ga = *owner;
+        const double* storage = ga.get_population().data();
+        int calls = 0;
+        ga.set_progress_callback([&](const BaseOptimizer& optimizer) {
+            CHECK(optimizer.get_population().data() == storage);
+            ++calls;
+            return false;
+        }, 2);
+        ga.optimize(5);
+        CHECK(calls == 2);
+        CHECK(ga.get_population().data() == storage);
+        ga.optimize(3);
+        CHECK(ga.get_population().data() == storage);
+    }
+    {
+        // Settling copies the generation back; results must not change.
+        std::unique_ptr<GA> stepped_owner = make_ga();
+        GA& stepped = *stepped_owner;
+        for (int k = 0; k < 9; ++k) {
+            stepped.tell(evaluate_all(stepped.ask()));
+        }
+        std::unique_ptr<GA> run_owner = make_ga();
+        GA& run = *run_owner;
+        run.optimize(8);
+        CHECK(stepped.get_best_fitness() == run.get_best_fitness());
+        CHECK(stepped.get_fitness() == run.get_fitness());
+    }
+    {
+        // Only the candidate rows need evaluating: values told for elites
+        // and clones are ignored and not counted.
+        std::unique_ptr<GA> stepped_owner = make_ga();
+        GA& stepped = *stepped_owner;
+        bool carried = false;
+        for (int k = 0; k < 9; ++k) {
+            const Population& candidates = stepped.ask();
+            std::vector<double> fitness(candidates.rows(), std::numeric_limits<double>::quiet_NaN());
+            const std::vector<int>* rows = stepped.candidate_rows();
+            carried = carried || rows != nullptr;
+            for (int i = 0; i < candidates.rows(); ++i) {
+                if (rows == nullptr || std::find(rows->begin(), rows->end(), i) != rows->end()) {
+                    fitness[i] = sphere(candidates.row_vector(i));
+                }
+            }
+            stepped.tell(fitness);
+        }
+        CHECK(carried);
+        std::unique_ptr<GA> run_owner = make_ga();
+        GA& run = *run_owner;
+        run.optimize(8);
+        CHECK(stepped.get_fitness() == run.get_fitness());
+        CHECK(stepped.get_evaluation_count() == run.get_evaluation_count());
+    }
+    return test_result();
+}
@@ -0,0 +1,89 @@
+// Inertia decay (use_w_decrement) must stay within [w_end, w_start]: with a
+// one-iteration schedule (which used to divide by zero and turn every
+// position into NaN) and when an ask()/tell() loop runs past max_iter
+// (which used to extrapolate w until the swarm diverged onto the bounds).
+
+#include "check.h"
+#include "pso.h"
+#include "sma.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+bool same_population(const BaseOptimizer& a, const BaseOptimizer& b) {
+    const Population& x = a.get_population();
+    const Population& y = b.get_population();
+    for (std::size_t k = 0; k < x.size(); ++k) {
+        if (!(x.data()[k] == y.data()[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Share of coordinates sitting exactly on a bound.
+double share_at_bounds(const BaseOptimizer& optimizer, double lo, double hi) {
+    const Population& x = optimizer.get_population();
+    int pinned = 0;
+    for (std::size_t k = 0; k < x.size(); ++k) {
+        pinned += (x.data()[k] == lo || x.data()[k] == hi) ? 1 : 0;
+    }
+    return static_cast<double>(pinned) / x.size();
+}
+
+}  // namespace
+
+int main() {
+    const double w_start = 0.9;
+    const double w_end = 0.4;
+    {
+        // max_iter = 1: decay holds w_end, so the run matches a fixed w_end,
+        // for optimize() and for ask()/tell() steps past the one iteration.
+        PSO decaying(16, 4, -5.0, 5.0, 1, 1.5, 1.5, w_start, 0.0, true, false, 3, true, false, 1,
+                     true, w_start, w_end);
+        PSO fixed(16, 4, -5.0, 5.0, 1, 1.5, 1.5, w_end, 0.0, true, false, 3);
+        decaying.set_objective(sphere);
+        fixed.set_objective(sphere);
+        decaying.optimize(1);
+        fixed.optimize(1);
+        for (int k = 0; k < 4; ++k) {
+            step(decaying);
+            step(fixed);
+        }
+        CHECK(std::isfinite(decaying.get_best_fitness()));
+        CHECK(same_population(decaying, fixed));
+
+        SMA decaying_sma(16, 4, -5.0, 5.0, 1, 0.5, 0.5, w_start, true, false, 3, true, true, w_start, w_end);
+        SMA fixed_sma(16, 4, -5.0, 5.0, 1, 0.5, 0.5, w_end, true, false, 3);
+        decaying_sma.set_objective(sphere);
+        fixed_sma.set_objective(sphere);
+        decaying_sma.optimize(1);
+        fixed_sma.optimize(1);
+        for (int k = 0; k < 4; ++k) {
+            step(decaying_sma);
+            step(fixed_sma);
+        }
+        CHECK(std::isfinite(decaying_sma.get_best_fitness()));
+        CHECK(same_population(decaying_sma, fixed_sma));
+    }
+    {
+        // An ask()/tell() loop six times longer than max_iter.
+        PSO pso(16, 4, -5.0, 5.0, 5, 1.5, 1.5, w_start, 0.0, true, false, 3, true, false, 1,
+                true, w_start, w_end);
+        pso.set_objective(sphere);
+        for (int k = 0; k < 30; ++k) {
+            step(pso);
+        }
+        CHECK(share_at_bounds(pso, -5.0, 5.0) < 0.25);
+        CHECK(pso.get_best_fitness() < 1.0);
+
+        SMA sma(16, 4, -5.0, 5.0, 5, 0.5, 0.5, w_start, true, false, 3, true, true, w_start, w_end);
+        sma.set_objective(sphere);
+        for (int k = 0; k < 30; ++k) {
+            step(sma);
+        }
+        CHECK(share_at_bounds(sma, -5.0, 5.0) < 0.25);
+    }
+    return test_result();
+}
@@ -0,0 +1,45 @@
+// An island's max_seconds bounds its whole IslandModel::optimize() call,
+// not each migration interval.
+
+#include "check.h"
+#include "island_model.h"
+#include "pso.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// One millisecond per evaluation: eight per iteration, so a migration
+// interval of five iterations takes about 40 ms.
+double slow_sphere(const std::vector<double>& x) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return sphere(x);
+}
+
+}  // namespace
+
+int main() {
+    using Clock = std::chrono::steady_clock;
+    std::vector<std::unique_ptr<PSO>> islands;
+    IslandModel model(MigrationTopology::Ring, 5, 1);
+    for (int k = 0; k < 2; ++k) {
+        islands.emplace_back(new PSO(8, 3, -5.0, 5.0, 1000, 1.5, 1.5, 0.7, 0.0, true, false, k));
+        islands.back()->set_objective(slow_sphere, false);
+        TerminationCriteria rules;
+        rules.max_seconds = 0.25;
+        islands.back()->set_termination(rules);
+        model.add_island(islands.back().get());
+    }
+
+    Clock::time_point start = Clock::now();
+    model.optimize(1000);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    CHECK(seconds < 2.0);
+    for (const std::unique_ptr<PSO>& island : islands) {
+        CHECK(island->get_stop_reason() == StopReason::Deadline);
+        CHECK(island->get_iteration() < 1000);
+    }
+    return test_result();
+}
@@ -0,0 +1,167 @@
+// Update kernels against a plain reference, on every row length from 1 to
+// 40 (vector bodies plus scalar tails) and with NaN and infinite inputs.
+// CTest runs this once per instruction set (BIOOPT_KERNEL_ISA), so the
+// scalar, AVX2 and AVX-512 paths are all held to the same results.
+
+#include "check.h"
+#include "kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+const int MAX_DIM = 40;
+
+template <typename T>
+bool same(T a, T b) {
+    return (std::isnan(a) && std::isnan(b)) || std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+// Clamps as documented: NaN velocities go to +v_max, NaN positions to the
+// lower bound, infinities to the nearer limit.
+template <typename T>
+T clamp_velocity(T vel, T v_max) {
+    return std::isnan(vel) ? v_max : std::min(std::max(vel, -v_max), v_max);
+}
+
+template <typename T>
+T clamp_position(T pos, T lo, T hi) {
+    return std::isnan(pos) ? lo : std::min(std::max(pos, lo), hi);
+}
+
+template <typename T>
+struct Rows {
+    std::vector<T> x, v, pbest, best, r1, r2;
+};
+
+// Random rows with NaN and +-inf sprinkled over positions, velocities and bests.
+template <typename T>
+Rows<T> make_rows(int dim, std::mt19937& rng) {
+    std::uniform_real_distribution<double> value(-8.0, 8.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    Rows<T> rows;
+    for (std::vector<T>* row : {&rows.x, &rows.v, &rows.pbest, &rows.best}) {
+        for (int d = 0; d < dim; ++d) {
+            row->push_back(static_cast<T>(value(rng)));
+        }
+    }
+    for (std::vector<T>* row : {&rows.r1, &rows.r2}) {
+        for (int d = 0; d < dim; ++d) {
+            row->push_back(static_cast<T>(unit(rng)));
+        }
+    }
+    const T specials[] = {std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::infinity(),
+                          -std::numeric_limits<T>::infinity()};
+    std::uniform_int_distribution<int> pick(0, 2);
+    for (std::vector<T>* row : {&rows.x, &rows.v, &rows.pbest, &rows.best}) {
+        for (int d = 0; d < dim; ++d) {
+            if (unit(rng) < 0.15) {
+                (*row)[d] = specials[pick(rng)];
+            }
+        }
+    }
+    return rows;
+}
+
+template <typename T>
+void pso_reference(const PSOUpdateParams& p, Rows<T>& rows) {
+    for (std::size_t d = 0; d < rows.x.size(); ++d) {
+        T x = rows.x[d];
+        T vel = T(p.w) * rows.v[d]
+              + T(p.c1) * rows.r1[d] * (rows.pbest[d] - x)
+              + T(p.c2) * rows.r2[d] * (rows.best[d] - x);
+        if (p.v_max > 0.0) {
+            vel = clamp_velocity(vel, T(p.v_max));
+        }
+        rows.v[d] = vel;
+        rows.x[d] = clamp_position(x + vel, T(p.lower_bound), T(p.upper_bound));
+    }
+}
+
+template <typename T>
+void sma_reference(const SMAUpdateParams& p, Rows<T>& rows) {
+    for (std::size_t d = 0; d < rows.x.size(); ++d) {
+        T x = rows.x[d];
+        T factor1 = T(p.c1) * rows.r1[d];
+        T factor2 = T(p.c2) * ((rows.r2[d] * T(2)) - T(1));
+        T delta = factor1 * (rows.best[d] - x) + factor2;
+        rows.x[d] = clamp_position(x + T(p.w) * delta, T(p.lower_bound), T(p.upper_bound));
+    }
+}
+
+template <typename T>
+bool same_rows(const std::vector<T>& a, const std::vector<T>& b) {
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (!same(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void check_double(std::mt19937& rng) {
+    for (double v_max : {0.0, 1.5}) {
+        PSOUpdateParams pso{0.7, 1.4, 1.6, v_max, -5.0, 5.0};
+        SMAUpdateParams sma{0.9, 0.8, 0.6, -5.0, 5.0};
+        for (int dim = 1; dim <= MAX_DIM; ++dim) {
+            Rows<double> input = make_rows<double>(dim, rng);
+
+            Rows<double> expected = input;
+            pso_reference(pso, expected);
+            Rows<double> fixed = input;
+            select_pso_kernel(dim, v_max > 0.0)(pso, dim, fixed.x.data(), fixed.v.data(), fixed.pbest.data(),
+                                                fixed.best.data(), fixed.r1.data(), fixed.r2.data());
+            Rows<double> generic = input;
+            pso_update_row(pso, dim, generic.x.data(), generic.v.data(), generic.pbest.data(),
+                           generic.best.data(), generic.r1.data(), generic.r2.data());
+            CHECK(same_rows(fixed.x, expected.x) && same_rows(fixed.v, expected.v));
+            CHECK(same_rows(generic.x, expected.x) && same_rows(generic.v, expected.v));
+
+            expected = input;
+            sma_reference(sma, expected);
+            fixed = input;
+            select_sma_kernel(dim)(sma, dim, fixed.x.data(), fixed.best.data(), fixed.r1.data(), fixed.r2.data());
+            generic = input;
+            sma_update_row(sma, dim, generic.x.data(), generic.best.data(), generic.r1.data(), generic.r2.data());
+            CHECK(same_rows(fixed.x, expected.x));
+            CHECK(same_rows(generic.x, expected.x));
+        }
+    }
+}
+
+void check_float(std::mt19937& rng) {
+    for (double v_max : {0.0, 1.5}) {
+        PSOUpdateParams pso{0.7, 1.4, 1.6, v_max, -5.0, 5.0};
+        SMAUpdateParams sma{0.9, 0.8, 0.6, -5.0, 5.0};
+        for (int dim = 1; dim <= MAX_DIM; ++dim) {
+            Rows<float> input = make_rows<float>(dim, rng);
+
+            Rows<float> expected = input;
+            pso_reference(pso, expected);
+            Rows<float> actual = input;
+            select_pso_kernel32(v_max > 0.0)(pso, dim, actual.x.data(), actual.v.data(), actual.pbest.data(),
+                                             actual.best.data(), actual.r1.data(), actual.r2.data());
+            CHECK(same_rows(actual.x, expected.x) && same_rows(actual.v, expected.v));
+
+            expected = input;
+            sma_reference(sma, expected);
+            actual = input;
+            select_sma_kernel32()(sma, dim, actual.x.data(), actual.best.data(), actual.r1.data(), actual.r2.data());
+            CHECK(same_rows(actual.x, expected.x));
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    std::printf("kernel ISA: %s\n", kernel_isa());
+    std::mt19937 rng(12345);
+    check_double(rng);
+    check_float(rng);
+    return test_result();
+}
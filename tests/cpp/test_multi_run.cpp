@@ -0,0 +1,65 @@
+// Runs stepped together by MultiRun must end exactly as the same runs
+// optimized alone: GA, which evaluates only its new genomes, and PSO side by
+// side, over several optimize() calls, with one run stopped early by its own
+// evaluation budget.
+
+#include "check.h"
+#include "ga.h"
+#include "multi_run.h"
+#include "pso.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace {
+
+double native_sphere(const double* x, std::size_t dim, void*) {
+    return sphere(std::vector<double>(x, x + dim));
+}
+
+std::vector<std::unique_ptr<BaseOptimizer>> make_runs() {
+    std::vector<std::unique_ptr<BaseOptimizer>> runs;
+    runs.emplace_back(new GA(20, 6, -5.0, 5.0, 40, true, false, 3, 0.7, 0.2));
+    runs.emplace_back(new PSO(16, 6, -5.0, 5.0, 40, 1.5, 1.5, 0.7, 0.0, true, false, 5));
+    runs.emplace_back(new GA(12, 6, -5.0, 5.0, 40, true, false, 11, 0.9, 0.1));
+    runs.emplace_back(new PSO(24, 6, -5.0, 5.0, 40, 2.0, 2.0, 0.6, 0.0, true, false, 13));
+    TerminationCriteria budget;
+    budget.max_evaluations = 150;
+    runs[3]->set_termination(budget);
+    return runs;
+}
+
+}  // namespace
+
+int main() {
+    std::vector<std::unique_ptr<BaseOptimizer>> alone = make_runs();
+    for (std::unique_ptr<BaseOptimizer>& run : alone) {
+        run->set_native_objective(native_sphere);
+        run->optimize(7);
+        run->optimize(5);
+    }
+
+    std::vector<std::unique_ptr<BaseOptimizer>> together = make_runs();
+    MultiRun multi(2);
+    for (std::unique_ptr<BaseOptimizer>& run : together) {
+        multi.add_run(run.get());
+    }
+    multi.set_native_objective(native_sphere);
+    multi.optimize(7);
+    multi.optimize(5);
+
+    CHECK(alone[3]->get_stop_reason() == StopReason::MaxEvaluations);
+    for (std::size_t k = 0; k < alone.size(); ++k) {
+        const BaseOptimizer& a = *alone[k];
+        const BaseOptimizer& b = *together[k];
+        CHECK(a.get_iteration() == b.get_iteration());
+        CHECK(a.get_evaluation_count() == b.get_evaluation_count());
+        CHECK(a.get_stop_reason() == b.get_stop_reason());
+        CHECK(a.get_best_fitness() == b.get_best_fitness());
+        CHECK(a.get_best_solution() == b.get_best_solution());
+        CHECK(a.get_fitness() == b.get_fitness());
+    }
+    std::vector<uint64_t> counts = multi.get_evaluation_counts();
+    CHECK(counts.size() == alone.size() && counts[0] == alone[0]->get_evaluation_count());
+    return test_result();
+}
@@ -0,0 +1,149 @@
+// Surrogate predictions must match a brute-force k-nearest-neighbour scan of
+// the same archive, whether the archive is scanned in full or indexed by the
+// k-d tree, with ties in distance broken by age, and after the oldest genomes
+// are evicted. A saved and reloaded surrogate predicts the same.
+
+#include "check.h"
+#include "surrogate.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// What the archive should hold: every finite insert, oldest first, with the
+// oldest quarter dropped whenever it is full.
+struct Archive {
+    int capacity;
+    int dim;
+    std::vector<std::vector<double>> genomes;
+    std::vector<double> values;
+
+    void insert(const std::vector<double>& x, double fitness) {
+        if (static_cast<int>(values.size()) == capacity) {
+            int drop = std::max(capacity / 4, 1);
+            genomes.erase(genomes.begin(), genomes.begin() + drop);
+            values.erase(values.begin(), values.begin() + drop);
+        }
+        genomes.push_back(x);
+        values.push_back(fitness);
+    }
+
+    // Inverse-squared-distance weighted mean of the k nearest by (distance,
+    // index); the mean of exact matches if there are any.
+    double predict(const std::vector<double>& x, int k) const {
+        std::vector<std::pair<double, int>> nearest;
+        for (int i = 0; i < static_cast<int>(values.size()); ++i) {
+            double sum = 0.0;
+            for (int d = 0; d < dim; ++d) {
+                double diff = x[d] - genomes[i][d];
+                sum += diff * diff;
+            }
+            nearest.push_back(std::make_pair(sum, i));
+        }
+        std::sort(nearest.begin(), nearest.end());
+        nearest.resize(std::min<std::size_t>(k, nearest.size()));
+        if (nearest.empty()) {
+            return 0.0;
+        }
+        double weighted = 0.0;
+        double total = 0.0;
+        for (const std::pair<double, int>& n : nearest) {
+            if (nearest[0].first == 0.0 && n.first != 0.0) {
+                break;
+            }
+            double weight = nearest[0].first == 0.0 ? 1.0 : 1.0 / n.first;
+            weighted += weight * values[n.second];
+            total += weight;
+        }
+        return weighted / total;
+    }
+};
+
+// Inserts random genomes one at a time, comparing predictions at fresh and
+// archived points after each. On a coarse grid, distances often tie.
+void check_against_brute_force(int dim, int capacity, int inserts, bool grid, std::mt19937& rng) {
+    SurrogateSettings settings;
+    settings.capacity = capacity;
+    settings.neighbors = 5;
+    Surrogate surrogate;
+    surrogate.configure(settings, dim);
+    Archive archive{capacity, dim, {}, {}};
+
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::uniform_int_distribution<int> cell(-2, 2);
+    auto draw = [&]() {
+        std::vector<double> x(dim);
+        for (double& v : x) {
+            v = grid ? cell(rng) : uniform(rng);
+        }
+        return x;
+    };
+
+    for (int n = 0; n < inserts; ++n) {
+        std::vector<double> x = draw();
+        double fitness = uniform(rng);
+        surrogate.insert(x.data(), fitness);
+        archive.insert(x, fitness);
+        CHECK(surrogate.size() == static_cast<int>(archive.values.size()));
+
+        for (int q = 0; q < 3; ++q) {
+            std::vector<double> query = draw();
+            CHECK(surrogate.predict(query.data()) == archive.predict(query, settings.neighbors));
+        }
+        const std::vector<double>& archived = archive.genomes[rng() % archive.genomes.size()];
+        CHECK(surrogate.predict(archived.data()) == archive.predict(archived, settings.neighbors));
+    }
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(7);
+    // 2^dim below, near and above the capacity: always indexed after a few
+    // inserts, indexed only once the archive is large, and never indexed.
+    // Each run inserts past the capacity, so eviction happens several times.
+    for (bool grid : {false, true}) {
+        check_against_brute_force(2, 60, 200, grid, rng);
+        check_against_brute_force(5, 100, 300, grid, rng);
+        check_against_brute_force(7, 200, 500, grid, rng);
+        check_against_brute_force(9, 200, 300, grid, rng);
+    }
+
+    // Save and load: same settings, archive, counter and predictions.
+    SurrogateSettings settings;
+    settings.capacity = 64;
+    settings.neighbors = 3;
+    settings.min_points = 10;
+    Surrogate source;
+    source.configure(settings, 3);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    for (int n = 0; n < 80; ++n) {
+        double x[3] = {uniform(rng), uniform(rng), uniform(rng)};
+        source.insert(x, uniform(rng));
+    }
+    source.count_screened(17);
+
+    CheckpointHeader header;
+    header.algorithm = "Surrogate";
+    header.dim = 3;
+    CheckpointWriter out(header);
+    source.save(out);
+    std::vector<unsigned char> bytes = out.finish();
+    CheckpointReader in(bytes.data(), bytes.size());
+    Surrogate loaded;
+    loaded.load(in, 3);
+    CHECK(in.remaining() == 0);
+    CHECK(loaded.size() == source.size());
+    CHECK(loaded.get_screened() == 17);
+    CHECK(loaded.get_settings().capacity == 64 && loaded.get_settings().neighbors == 3 &&
+          loaded.get_settings().min_points == 10);
+    CHECK(loaded.ready());
+    for (int q = 0; q < 50; ++q) {
+        double x[3] = {uniform(rng), uniform(rng), uniform(rng)};
+        CHECK(loaded.predict(x) == source.predict(x));
+    }
+    return test_result();
+}
@@ -0,0 +1,114 @@
+// Neighborhood bests kept up by improved() must match a full reset_bests()
+// after every improvement, including when personal bests tie: both rank by
+// (fitness, index), so a tie goes to the lowest index. Neighbor sizes are
+// bounded by the swarm.
+
+#include "check.h"
+#include "pso.h"
+#include "topology.h"
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const int N = 24;
+
+bool same_bests(const Topology& a, const Topology& b) {
+    for (int i = 0; i < N; ++i) {
+        if (a.best(i) != b.best(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Personal bests drawn from a few values so that ties are common, with a
+// NaN or two; improvements move one particle to a better value.
+void check_incremental(TopologyKind kind, bool minimize, std::mt19937& rng) {
+    std::uniform_int_distribution<int> level(0, 4);
+    std::uniform_int_distribution<int> particle(0, N - 1);
+    std::vector<double> fitness(N);
+    for (double& f : fitness) {
+        f = level(rng);
+    }
+    fitness[particle(rng)] = std::numeric_limits<double>::quiet_NaN();
+
+    Topology topology;
+    topology.build(kind, N, 2, 99);
+    topology.reset_bests(fitness, minimize);
+    for (int step = 0; step < 200; ++step) {
+        int i = particle(rng);
+        double target = level(rng);
+        if (!std::isnan(fitness[i]) && (minimize ? target >= fitness[i] : target <= fitness[i])) {
+            continue;
+        }
+        fitness[i] = target;
+        topology.improved(i, fitness, minimize);
+
+        Topology fresh;
+        fresh.build(kind, N, 2, 99);
+        fresh.reset_bests(fitness, minimize);
+        CHECK(same_bests(topology, fresh));
+    }
+}
+
+}  // namespace
+
+int main() {
+    // Equal fitness everywhere: each ring neighborhood picks its lowest index.
+    Topology ring;
+    ring.build(TopologyKind::Ring, N, 1, 0);
+    ring.reset_bests(std::vector<double>(N, 1.0), true);
+    CHECK(ring.best(0) == 0);
+    CHECK(ring.best(5) == 4);
+    CHECK(ring.best(N - 1) == 0);
+
+    // A later particle that only ties the current best does not take over;
+    // an earlier one does.
+    std::vector<double> fitness(N, 2.0);
+    fitness[5] = 1.0;
+    ring.reset_bests(fitness, true);
+    CHECK(ring.best(5) == 5 && ring.best(6) == 5);
+    fitness[6] = 1.0;
+    ring.improved(6, fitness, true);
+    CHECK(ring.best(6) == 5 && ring.best(7) == 6);
+    fitness[4] = 1.0;
+    ring.improved(4, fitness, true);
+    CHECK(ring.best(5) == 4);
+
+    // Oversized neighborhoods are clamped to the whole swarm when built, and
+    // rejected by PSO::set_topology().
+    Topology wide;
+    wide.build(TopologyKind::Ring, N, INT_MAX, 0);
+    CHECK(wide.degree(0) == N);
+    wide.build(TopologyKind::RandomRegular, N, N / 2, 0);
+    CHECK(wide.degree(3) == N);
+    wide.build(TopologyKind::Dynamic, N, INT_MAX, 0);
+    CHECK(wide.degree(0) <= N);
+
+    PSO pso(8, 2, -1.0, 1.0, 10, 1.5, 1.5, 0.7);
+    pso.set_topology(TopologyKind::Ring, 4);
+    pso.set_topology(TopologyKind::Dynamic, 7);
+    for (TopologyKind kind : {TopologyKind::Ring, TopologyKind::Dynamic}) {
+        bool thrown = false;
+        try {
+            pso.set_topology(kind, INT_MAX);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+    CHECK(pso.get_neighbor_size() == 7);
+
+    std::mt19937 rng(2024);
+    for (TopologyKind kind : {TopologyKind::Ring, TopologyKind::VonNeumann, TopologyKind::RandomRegular,
+                              TopologyKind::Dynamic}) {
+        check_incremental(kind, true, rng);
+        check_incremental(kind, false, rng);
+    }
+    return test_result();
+}
@@ -27,6 +27,16 @@ def mse_loss(params):
     mse = np.mean((y - predictions) ** 2)
     return mse
 
+# --- Batched Loss: evaluates the whole population in one call ---
+def mse_loss_batch(population):
+    """
+    Vectorized MSE for an (N x 2) array of [m, b] rows.
+    Returns N loss values, one per candidate.
+    """
+    m, b = population[:, 0:1], population[:, 1:2]
+    predictions = m * x + b
+    return np.mean((y - predictions) ** 2, axis=1)
+
 # --- Run Optimizer to Optimize the Linear Model ---
 def run_optimizer(optimizer_class, hyperparams, optimizer_name):
     """
@@ -77,7 +87,10 @@ def run_optimizer(optimizer_class, hyperparams, optimizer_name):
     else:
         raise ValueError(f"Unsupported optimizer: {optimizer_name}")
 
-    optimizer.set_objective(mse_loss)
+    if hyperparams.get("batch", False):
+        optimizer.set_batch_objective(mse_loss_batch)
+    else:
+        optimizer.set_objective(mse_loss)
     optimizer.optimize()
     best_params = np.array(optimizer.get_best_solution())  # Expect a 2-element array: [m, b]
     best_loss = mse_loss(best_params)
@@ -94,7 +107,8 @@ if __name__ == "__main__":
         "w": 0.7,
         "v_max": 0.0,  # For PSO
         "verbose": False,
-        "seed": 42
+        "seed": 42,
+        "batch": False  # True evaluates the swarm with one vectorized call per iteration
     }
 
     # Run SMA
@@ -105,6 +119,11 @@ if __name__ == "__main__":
     pso_params, pso_loss = run_optimizer(bioopt.PSO, default_hyperparams, "PSO")
     m_pso, b_pso = pso_params[0], pso_params[1]
 
+    # Same runs through the batched objective path
+    batch_hyperparams = dict(default_hyperparams, batch=True)
+    _, sma_batch_loss = run_optimizer(bioopt.SMA, batch_hyperparams, "SMA (batch)")
+    _, pso_batch_loss = run_optimizer(bioopt.PSO, batch_hyperparams, "PSO (batch)")
+
     # Print results
     print("Optimized Linear Model Parameters (SMA):")
     print(f"  m (slope) = {m_sma:.4f}")
@@ -116,6 +135,10 @@ if __name__ == "__main__":
     print(f"  b (intercept) = {b_pso:.4f}")
     print(f"Best MSE Loss (PSO): {pso_loss:.4f}")
 
+    print("\nBatched objective:")
+    print(f"  Best MSE Loss (SMA): {sma_batch_loss:.4f}")
+    print(f"  Best MSE Loss (PSO): {pso_batch_loss:.4f}")
+
     # --- Visualization ---
     plt.figure(figsize=(10, 6))
 
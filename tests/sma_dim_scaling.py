@@ -0,0 +1,55 @@
+import time
+import numpy as np
+import matplotlib.pyplot as plt
+import bioopt
+
+#############################
+# SMA update cost vs. dimension
+#############################
+# Times SMA.update_positions() for a fixed population across increasing
+# dimensions. With the fused per-row update the cost grows linearly in dim,
+# so the time per coordinate should stay roughly flat.
+
+NUM_INDIVIDUALS = 200
+REPEATS = 20
+DIMS = [10, 50, 100, 250, 500, 1000, 2000]
+
+def time_sma_update(dim):
+    sma_solver = bioopt.SMA(
+        num_individuals=NUM_INDIVIDUALS,
+        dim=dim,
+        lower_bound=-5.0,
+        upper_bound=5.0,
+        max_iter=REPEATS,
+        c1=1.5,
+        c2=1.5,
+        w=0.5,
+        seed=42
+    )
+    sma_solver.update_positions(0)  # warm-up
+    start = time.perf_counter()
+    for it in range(REPEATS):
+        sma_solver.update_positions(it)
+    return (time.perf_counter() - start) / REPEATS
+
+if __name__ == "__main__":
+    times = []
+    print(f"{'dim':>6} {'ms/update':>12} {'ns/coordinate':>15}")
+    for dim in DIMS:
+        t = time_sma_update(dim)
+        times.append(t)
+        print(f"{dim:>6} {t * 1e3:>12.3f} {t * 1e9 / (NUM_INDIVIDUALS * dim):>15.2f}")
+
+    # Fitted slope on log-log axes: ~1 means linear scaling, ~2 quadratic.
+    slope = np.polyfit(np.log(DIMS), np.log(times), 1)[0]
+    print(f"Scaling exponent: {slope:.2f}")
+
+    plt.figure(figsize=(6, 4))
+    plt.loglog(DIMS, times, marker='o', label="SMA.update_positions")
+    plt.loglog(DIMS, [times[0] * d / DIMS[0] for d in DIMS], linestyle='--', label="linear reference")
+    plt.title(f"SMA update time vs. dimension (N={NUM_INDIVIDUALS})")
+    plt.xlabel("dim")
+    plt.ylabel("seconds per update")
+    plt.legend()
+    plt.grid(True, which="both")
+    plt.show()